@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "metrics_format.h"
+#include "performance_monitor.h"
+#include "proc_stat_parser.h"
+
+#include "micro_benchmark.h"
+
+// Microbenchmarks for the hot collector/serializer paths, driven by
+// synthetic fixtures so results are reproducible off-box.
+
+namespace {
+
+// /proc/stat fixture: aggregate line plus 64 cores.
+std::string make_proc_stat_fixture(size_t cores) {
+    std::string out = "cpu  74608 2520 24433 1117073 6176 4054 0 0 0 0\n";
+    for (size_t i = 0; i < cores; ++i) {
+        out += "cpu" + std::to_string(i) +
+               " 1165 21 381 17454 96 63 0 0 0 0\n";
+    }
+    out += "intr 33124 9 0 0 0\nctxt 23456789\n";
+    return out;
+}
+
+// /proc/[pid]/stat fixture with an awkward comm on purpose.
+const char* PID_STAT_FIXTURE =
+    "4242 (bench (proc)) S 1 4242 4242 0 -1 4194560 12003 0 80 0 "
+    "4200 1300 0 0 20 0 17 0 8260 139264000 8514 "
+    "18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0";
+
+MetricSnapshot make_snapshot_fixture() {
+    MetricSnapshot snapshot;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.cpu_usage = 42.57;
+    snapshot.memory_usage = 63.11;
+    snapshot.disk_usage = 71.93;
+    snapshot.network_rx = 1048576.0;
+    snapshot.network_tx = 524288.0;
+    snapshot.cgroup_cpu_usage = 87.5;
+    snapshot.per_core_cpu.assign(64, 39.8);
+    snapshot.interface_rates = {
+        {"eth0", 1000000.0, 500000.0},
+        {"eth1", 48576.0, 24288.0},
+        {"lo", 128.0, 128.0},
+    };
+    auto table = std::make_shared<ProcessTable>();
+    for (uint32_t i = 0; i < 10; ++i) {
+        std::string name = "benchmark_process_" + std::to_string(i);
+        table->add(1000 + i, name.data(), name.size(), 12.5,
+                   128ull * 1024 * 1024, ProcessState::Running);
+    }
+    snapshot.top_processes = table;
+    return snapshot;
+}
+
+std::vector<HistoryEntry> make_history_fixture(size_t count) {
+    std::vector<HistoryEntry> history(count);
+    for (size_t i = 0; i < count; ++i) {
+        history[i].timestamp_ms = 1700000000000ll + static_cast<int64_t>(i) * 1000;
+        history[i].cpu_usage = 25.0 + (i % 50);
+        history[i].memory_usage = 60.0 + (i % 20);
+        history[i].disk_usage = 70.5;
+        history[i].network_rx = 1e6;
+        history[i].network_tx = 5e5;
+    }
+    return history;
+}
+
+void BM_parse_proc_stat(benchmark::State& state) {
+    std::string fixture = make_proc_stat_fixture(64);
+    CpuTicks aggregate;
+    std::vector<CpuTicks> cores;
+    for (auto _ : state) {
+        size_t lines = parse_proc_stat_cpus(fixture.c_str(), aggregate, cores);
+        benchmark::DoNotOptimize(lines);
+        benchmark::DoNotOptimize(aggregate);
+    }
+}
+BENCHMARK(BM_parse_proc_stat);
+
+void BM_parse_pid_stat(benchmark::State& state) {
+    for (auto _ : state) {
+        PidStatRecord record;
+        bool ok = parse_pid_stat(PID_STAT_FIXTURE, record);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(record);
+    }
+}
+BENCHMARK(BM_parse_pid_stat);
+
+void BM_format_metrics(benchmark::State& state) {
+    MetricSnapshot snapshot = make_snapshot_fixture();
+    for (auto _ : state) {
+        std::string body = format_metrics_json(snapshot);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(BM_format_metrics);
+
+void BM_format_history_1000(benchmark::State& state) {
+    std::vector<HistoryEntry> history = make_history_fixture(1000);
+    for (auto _ : state) {
+        std::string body = format_history_json(history);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(BM_format_history_1000);
+
+void BM_history_ring_read_1000(benchmark::State& state) {
+    MetricHistoryRing ring(3600);
+    for (const auto& entry : make_history_fixture(3600)) {
+        ring.push(entry);
+    }
+    for (auto _ : state) {
+        std::vector<HistoryEntry> out = ring.read(1000);
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_history_ring_read_1000);
+
+void BM_series_store_get_series(benchmark::State& state) {
+    MetricSeriesStore store(3600);
+    for (const auto& entry : make_history_fixture(3600)) {
+        store.push_row(entry);
+    }
+    for (auto _ : state) {
+        std::vector<double> series = store.get_series(MetricId::CpuUsage, 1000);
+        benchmark::DoNotOptimize(series);
+    }
+}
+BENCHMARK(BM_series_store_get_series);
+
+void BM_rollup_add_sample(benchmark::State& state) {
+    RollupTier tier(std::chrono::minutes(1), 1440);
+    HistoryEntry entry = make_history_fixture(1)[0];
+    for (auto _ : state) {
+        entry.timestamp_ms += 1000;
+        tier.add_sample(entry);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_rollup_add_sample);
+
+} // namespace
+
+BENCHMARK_MAIN()
@@ -0,0 +1,402 @@
+// Load generator for the HTTP endpoints: N keep-alive connections
+// driven closed-loop from one epoll thread (each connection sends its
+// next request the moment the previous response completes), an
+// optional set of /stream subscribers, and latency percentiles from
+// the same histogram the daemon uses for /debug/self. A soak mode
+// watches the daemon's VmRSS while the load runs and fails the run if
+// it drifts upward — the slow-leak check a metrics daemon needs.
+//
+//   performance_monitor_loadgen [host:port]
+//       --connections N       request connections (default 16)
+//       --streams N           /stream subscribers (default 0)
+//       --history-share P     percent of requests hitting /history
+//                             instead of /metrics (default 25)
+//       --duration-s S        run length (default 10)
+//       --soak-pid PID        sample VmRSS of PID every 10 s and fail
+//                             if first->last window growth exceeds
+//       --rss-growth-limit-kb N   (default 4096)
+
+#ifdef _WIN32
+#include <cstdio>
+int main() {
+    std::fprintf(stderr, "loadgen requires the Linux build\n");
+    return 1;
+}
+#else
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "self_stats.h"
+
+namespace {
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Options {
+    std::string host = "localhost";
+    int port = 9000;
+    int connections = 16;
+    int streams = 0;
+    int history_share = 25;
+    int duration_s = 10;
+    int soak_pid = 0;
+    long rss_growth_limit_kb = 4096;
+};
+
+struct LoadConnection {
+    int fd = -1;
+    bool is_stream = false;
+    bool connected = false;
+    std::string in_buffer;
+    int64_t sent_ns = 0;
+    int64_t retry_at_ns = 0;  // backoff after a failed connect
+    uint64_t completed = 0;
+    uint64_t stream_frames = 0;
+};
+
+long read_vm_rss_kb(int pid) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE* file = std::fopen(path, "r");
+    if (!file) return -1;
+    char line[256];
+    long rss = -1;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, "VmRSS:", 6) == 0) {
+            rss = std::atol(line + 6);
+            break;
+        }
+    }
+    std::fclose(file);
+    return rss;
+}
+
+bool resolve(const Options& options, sockaddr_in& addr) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(options.host.c_str(),
+                    std::to_string(options.port).c_str(),
+                    &hints, &result) != 0 || !result) {
+        return false;
+    }
+    std::memcpy(&addr, result->ai_addr, sizeof(addr));
+    freeaddrinfo(result);
+    return true;
+}
+
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const Options& options) : options_(options) {}
+
+    int run() {
+        if (!resolve(options_, addr_)) {
+            std::fprintf(stderr, "cannot resolve %s:%d\n",
+                         options_.host.c_str(), options_.port);
+            return 1;
+        }
+
+        epoll_fd_ = epoll_create1(0);
+        connections_.resize(
+            static_cast<size_t>(options_.connections + options_.streams));
+        for (size_t i = 0; i < connections_.size(); ++i) {
+            connections_[i].is_stream =
+                i >= static_cast<size_t>(options_.connections);
+            open_connection(i);
+        }
+
+        const int64_t start_ns = now_ns();
+        const int64_t end_ns =
+            start_ns + options_.duration_s * 1000000000ll;
+        int64_t next_report_ns = start_ns + 10 * 1000000000ll;
+        long first_rss = -1;
+        long last_rss = -1;
+
+        epoll_event events[64];
+        while (now_ns() < end_ns) {
+            int timeout = static_cast<int>(
+                std::min<int64_t>(200, (end_ns - now_ns()) / 1000000 + 1));
+            int ready = epoll_wait(epoll_fd_, events, 64, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                std::perror("epoll_wait");
+                return 1;
+            }
+            int64_t now = now_ns();
+            for (int i = 0; i < ready; ++i) {
+                handle_io(events[i].data.u64, events[i].events, now);
+            }
+
+            for (size_t i = 0; i < connections_.size(); ++i) {
+                LoadConnection& conn = connections_[i];
+                if (conn.fd < 0 && conn.retry_at_ns != 0 &&
+                    now >= conn.retry_at_ns) {
+                    conn.retry_at_ns = 0;
+                    open_connection(i);
+                }
+            }
+
+            if (now >= next_report_ns) {
+                next_report_ns += 10 * 1000000000ll;
+                if (options_.soak_pid > 0) {
+                    long rss = read_vm_rss_kb(options_.soak_pid);
+                    if (rss > 0) {
+                        if (first_rss < 0) first_rss = rss;
+                        last_rss = rss;
+                    }
+                    std::printf("t=%-6llds requests=%-10llu errors=%-6llu "
+                                "daemon_rss=%ld kB\n",
+                                static_cast<long long>((now - start_ns) / 1000000000ll),
+                                static_cast<unsigned long long>(total_completed_),
+                                static_cast<unsigned long long>(errors_),
+                                rss);
+                }
+            }
+        }
+        const double elapsed_s =
+            static_cast<double>(now_ns() - start_ns) / 1e9;
+
+        report(elapsed_s);
+
+        if (options_.soak_pid > 0 && first_rss > 0 && last_rss > 0) {
+            long growth = last_rss - first_rss;
+            std::printf("daemon RSS: %ld kB -> %ld kB (%+ld kB)\n",
+                        first_rss, last_rss, growth);
+            if (growth > options_.rss_growth_limit_kb) {
+                std::printf("FAIL: RSS grew beyond %ld kB limit\n",
+                            options_.rss_growth_limit_kb);
+                return 1;
+            }
+        }
+        return errors_ > 0 && total_completed_ == 0 ? 1 : 0;
+    }
+
+private:
+    void open_connection(size_t index) {
+        LoadConnection& conn = connections_[index];
+        conn.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (conn.fd < 0) {
+            ++errors_;
+            return;
+        }
+        int rc = connect(conn.fd, reinterpret_cast<sockaddr*>(&addr_),
+                         sizeof(addr_));
+        if (rc < 0 && errno != EINPROGRESS) {
+            close(conn.fd);
+            conn.fd = -1;
+            ++errors_;
+            return;
+        }
+        conn.connected = false;
+        conn.in_buffer.clear();
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT;
+        ev.data.u64 = index;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, conn.fd, &ev);
+    }
+
+    void reset_connection(size_t index) {
+        LoadConnection& conn = connections_[index];
+        if (conn.fd >= 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, conn.fd, nullptr);
+            close(conn.fd);
+            conn.fd = -1;
+        }
+        ++errors_;
+        if (conn.connected) {
+            open_connection(index); // keep offered load constant
+        } else {
+            // A connect that never completed means the server is not
+            // accepting; back off instead of hammering it with SYNs.
+            conn.retry_at_ns = now_ns() + 200 * 1000000ll;
+        }
+    }
+
+    void send_next_request(size_t index, int64_t now) {
+        LoadConnection& conn = connections_[index];
+        const char* request;
+        if (conn.is_stream) {
+            request = "GET /stream HTTP/1.1\r\nHost: loadgen\r\n\r\n";
+        } else if (static_cast<int>(conn.completed % 100) <
+                   options_.history_share) {
+            request = "GET /history HTTP/1.1\r\nHost: loadgen\r\n\r\n";
+        } else {
+            request = "GET /metrics HTTP/1.1\r\nHost: loadgen\r\n\r\n";
+        }
+        size_t length = std::strlen(request);
+        if (write(conn.fd, request, length) != static_cast<ssize_t>(length)) {
+            reset_connection(index);
+            return;
+        }
+        conn.sent_ns = now;
+    }
+
+    void handle_io(uint64_t index, uint32_t events, int64_t now) {
+        LoadConnection& conn = connections_[index];
+        if (conn.fd < 0) return;
+
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            reset_connection(index);
+            return;
+        }
+
+        if (!conn.connected && (events & EPOLLOUT)) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err != 0) {
+                reset_connection(index);
+                return;
+            }
+            conn.connected = true;
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = index;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+            send_next_request(index, now);
+        }
+
+        if (events & EPOLLIN) {
+            char buffer[16384];
+            while (true) {
+                ssize_t n = read(conn.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    conn.in_buffer.append(buffer, static_cast<size_t>(n));
+                } else if (n == 0) {
+                    reset_connection(index);
+                    return;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                } else if (errno == EINTR) {
+                    continue;
+                } else {
+                    reset_connection(index);
+                    return;
+                }
+            }
+            consume(index, now);
+        }
+    }
+
+    void consume(size_t index, int64_t now) {
+        LoadConnection& conn = connections_[index];
+        if (conn.is_stream) {
+            // Count SSE frames (blank-line terminated) and discard.
+            size_t pos;
+            while ((pos = conn.in_buffer.find("\n\n")) != std::string::npos) {
+                ++conn.stream_frames;
+                conn.in_buffer.erase(0, pos + 2);
+            }
+            return;
+        }
+
+        while (true) {
+            size_t header_end = conn.in_buffer.find("\r\n\r\n");
+            if (header_end == std::string::npos) return;
+            size_t length_pos = conn.in_buffer.find("Content-Length: ");
+            if (length_pos == std::string::npos || length_pos > header_end) {
+                reset_connection(index);
+                return;
+            }
+            size_t body_length = static_cast<size_t>(
+                std::atol(conn.in_buffer.c_str() + length_pos + 16));
+            if (conn.in_buffer.size() < header_end + 4 + body_length) return;
+
+            conn.in_buffer.erase(0, header_end + 4 + body_length);
+            ++conn.completed;
+            ++total_completed_;
+            histogram_.record(static_cast<uint64_t>(now - conn.sent_ns));
+            send_next_request(index, now);
+        }
+    }
+
+    void report(double elapsed_s) {
+        uint64_t frames = 0;
+        for (const LoadConnection& conn : connections_) {
+            frames += conn.stream_frames;
+        }
+
+        std::printf("\n%d request connections, %d stream subscribers, "
+                    "%.1f s\n",
+                    options_.connections, options_.streams, elapsed_s);
+        std::printf("requests:   %llu (%.0f/s), errors: %llu\n",
+                    static_cast<unsigned long long>(total_completed_),
+                    static_cast<double>(total_completed_) / elapsed_s,
+                    static_cast<unsigned long long>(errors_));
+        std::printf("latency:    p50 %.1f us, p90 %.1f us, p99 %.1f us, "
+                    "max %.1f us\n",
+                    static_cast<double>(histogram_.percentile_ns(0.50)) / 1e3,
+                    static_cast<double>(histogram_.percentile_ns(0.90)) / 1e3,
+                    static_cast<double>(histogram_.percentile_ns(0.99)) / 1e3,
+                    static_cast<double>(histogram_.max_ns()) / 1e3);
+        if (options_.streams > 0) {
+            std::printf("sse frames: %llu\n",
+                        static_cast<unsigned long long>(frames));
+        }
+    }
+
+    Options options_;
+    sockaddr_in addr_{};
+    int epoll_fd_ = -1;
+    std::vector<LoadConnection> connections_;
+    LatencyHistogram histogram_;
+    uint64_t total_completed_ = 0;
+    uint64_t errors_ = 0;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next_int = [&](int& out) {
+            if (i + 1 < argc) out = std::atoi(argv[++i]);
+        };
+        if (arg == "--connections") {
+            next_int(options.connections);
+        } else if (arg == "--streams") {
+            next_int(options.streams);
+        } else if (arg == "--history-share") {
+            next_int(options.history_share);
+        } else if (arg == "--duration-s") {
+            next_int(options.duration_s);
+        } else if (arg == "--soak-pid") {
+            next_int(options.soak_pid);
+        } else if (arg == "--rss-growth-limit-kb") {
+            int limit = 0;
+            next_int(limit);
+            options.rss_growth_limit_kb = limit;
+        } else {
+            size_t colon = arg.rfind(':');
+            if (colon == std::string::npos) {
+                options.host = arg;
+            } else {
+                options.host = arg.substr(0, colon);
+                options.port = std::atoi(arg.c_str() + colon + 1);
+            }
+        }
+    }
+
+    LoadGenerator generator(options);
+    return generator.run();
+}
+
+#endif // _WIN32
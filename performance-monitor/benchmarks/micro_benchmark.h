@@ -0,0 +1,111 @@
+#ifndef MICRO_BENCHMARK_H
+#define MICRO_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Minimal Google-Benchmark-style harness: BENCHMARK(fn) registers a
+// void(benchmark::State&) function, BENCHMARK_MAIN() runs them all.
+// Each benchmark is re-run with a growing iteration count until the
+// timed region lasts long enough to trust, then ns/op is reported.
+// Self-contained so the target builds without an external dependency.
+namespace benchmark {
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory() {
+    asm volatile("" ::: "memory");
+}
+
+class State {
+public:
+    explicit State(uint64_t iterations) : iterations_(iterations) {}
+
+    // Non-trivial token so `for (auto _ : state)` doesn't trip
+    // unused-variable warnings, same trick Google Benchmark uses.
+    struct IterationToken {
+        ~IterationToken() {}
+    };
+
+    struct iterator {
+        uint64_t remaining;
+        bool operator!=(const iterator& other) const {
+            return remaining != other.remaining;
+        }
+        void operator++() { --remaining; }
+        IterationToken operator*() const { return IterationToken{}; }
+    };
+
+    iterator begin() const { return {iterations_}; }
+    iterator end() const { return {0}; }
+    uint64_t iterations() const { return iterations_; }
+
+private:
+    uint64_t iterations_;
+};
+
+using BenchmarkFn = void (*)(State&);
+
+struct Registration {
+    const char* name;
+    BenchmarkFn fn;
+};
+
+inline std::vector<Registration>& registry() {
+    static std::vector<Registration> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const char* name, BenchmarkFn fn) {
+        registry().push_back({name, fn});
+    }
+};
+
+inline void RunAll() {
+    static const double MIN_RUN_NS = 2e8; // 200 ms timed region
+
+    printf("%-28s %14s %14s\n", "benchmark", "iterations", "ns/op");
+    for (const auto& bench : registry()) {
+        uint64_t iterations = 1;
+        double elapsed_ns = 0.0;
+
+        for (;;) {
+            State state(iterations);
+            auto start = std::chrono::steady_clock::now();
+            bench.fn(state);
+            auto stop = std::chrono::steady_clock::now();
+            elapsed_ns = std::chrono::duration<double, std::nano>(stop - start).count();
+            if (elapsed_ns >= MIN_RUN_NS) break;
+
+            // Aim straight for the target window instead of doubling
+            // forever; cap the growth factor to keep runs bounded.
+            double factor = elapsed_ns > 0.0 ? MIN_RUN_NS / elapsed_ns * 1.4 : 100.0;
+            if (factor > 100.0) factor = 100.0;
+            if (factor < 2.0) factor = 2.0;
+            iterations = static_cast<uint64_t>(iterations * factor);
+        }
+
+        printf("%-28s %14llu %14.1f\n", bench.name,
+               static_cast<unsigned long long>(iterations),
+               elapsed_ns / static_cast<double>(iterations));
+    }
+}
+
+} // namespace benchmark
+
+#define BENCHMARK(fn) \
+    static ::benchmark::Registrar fn##_registrar(#fn, fn)
+
+#define BENCHMARK_MAIN() \
+    int main() {                 \
+        ::benchmark::RunAll();   \
+        return 0;                \
+    }
+
+#endif // MICRO_BENCHMARK_H
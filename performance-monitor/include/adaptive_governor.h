@@ -0,0 +1,80 @@
+#ifndef ADAPTIVE_GOVERNOR_H
+#define ADAPTIVE_GOVERNOR_H
+
+#include <atomic>
+#include <cstddef>
+
+// Sheds collection detail when the monitor's own CPU share crosses its
+// budget, so the monitor stays cheap precisely when the host is
+// saturated. Three levels: full fidelity, then shrink the top-process
+// list and drop per-pid enrichment, then also stretch the process-scan
+// cadence. The cheap scalar collectors are never touched — a melting
+// host still gets full-rate cpu/memory/disk/network samples.
+//
+// The scheduler thread feeds one measurement per window and applies
+// the knobs; the process worker reads the level concurrently, hence
+// the atomic.
+class AdaptiveGovernor {
+public:
+    static const int LEVEL_COUNT = 3;
+
+    explicit AdaptiveGovernor(double budget_percent = 0.5)
+        : budget_percent_(budget_percent) {}
+
+    // Feed one window's self-CPU share (percent of one core). Returns
+    // the level in force afterwards. Two bad windows escalate — a
+    // saturated host is exactly when we must react — but it takes six
+    // clean ones to restore a level, so fidelity doesn't flap.
+    int update(double self_cpu_percent) {
+        int level = level_.load(std::memory_order_relaxed);
+        if (self_cpu_percent > budget_percent_) {
+            under_windows_ = 0;
+            if (++over_windows_ >= ESCALATE_AFTER && level < LEVEL_COUNT - 1) {
+                level_.store(++level, std::memory_order_relaxed);
+                over_windows_ = 0;
+            }
+        } else if (self_cpu_percent < budget_percent_ * 0.5) {
+            over_windows_ = 0;
+            if (++under_windows_ >= RESTORE_AFTER && level > 0) {
+                level_.store(--level, std::memory_order_relaxed);
+                under_windows_ = 0;
+            }
+        } else {
+            // Between half-budget and budget: hold the current level.
+            over_windows_ = 0;
+            under_windows_ = 0;
+        }
+        return level;
+    }
+
+    int level() const { return level_.load(std::memory_order_relaxed); }
+
+    double budget_percent() const { return budget_percent_; }
+
+    // Stretch factor for the process-scan cadence.
+    int process_scan_multiplier() const {
+        static const int multipliers[LEVEL_COUNT] = {1, 1, 4};
+        return multipliers[level()];
+    }
+
+    // The top-N list shrinks before the cadence stretches.
+    size_t top_process_count(size_t base) const {
+        static const size_t divisors[LEVEL_COUNT] = {1, 2, 3};
+        size_t count = base / divisors[level()];
+        return count > 0 ? count : 1;
+    }
+
+    // Per-pid smaps_rollup/io reads are the first thing to go.
+    bool enrich_processes() const { return level() == 0; }
+
+private:
+    static const int ESCALATE_AFTER = 2;
+    static const int RESTORE_AFTER = 6;
+
+    double budget_percent_;
+    std::atomic<int> level_{0};
+    int over_windows_ = 0;
+    int under_windows_ = 0;
+};
+
+#endif // ADAPTIVE_GOVERNOR_H
@@ -0,0 +1,144 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "metric_registry.h"
+#include "performance_monitor.h"
+
+// Threshold/duration alerting evaluated inline in the monitor loop.
+//
+// Rules are compiled at startup into a flat table; each tick costs one
+// comparison and a state-machine step per rule, with no allocation.
+// Hysteresis: a breach must hold for the rule's duration before the
+// alert fires, and must stay clear for the same duration before it
+// resolves, so transitions are emitted once instead of a log line per
+// sample while the condition holds.
+
+enum class AlertComparison : uint8_t { Above, Below };
+
+enum class AlertPhase : uint8_t { Inactive, Pending, Firing, Clearing };
+
+struct AlertRule {
+    std::string name;       // human-readable, e.g. "cpu > 80 for 30s"
+    MetricId metric;
+    AlertComparison comparison;
+    double threshold;
+    int64_t hold_ms;        // breach (and clear) must persist this long
+};
+
+class AlertEngine {
+public:
+    void add_rule(const AlertRule& rule) {
+        rules_.push_back({rule, AlertPhase::Inactive, 0});
+    }
+
+    size_t rule_count() const { return rules_.size(); }
+
+    // One evaluation pass; on_transition(rule, firing, value) is called
+    // only when a rule changes between firing and resolved.
+    template <typename OnTransition>
+    void evaluate(const HistoryEntry& entry, OnTransition on_transition) {
+        for (Slot& slot : rules_) {
+            double value = entry.*metric_descriptor(slot.rule.metric).history_field;
+            bool breach = slot.rule.comparison == AlertComparison::Above
+                              ? value > slot.rule.threshold
+                              : value < slot.rule.threshold;
+            int64_t now_ms = entry.timestamp_ms;
+
+            switch (slot.phase) {
+                case AlertPhase::Inactive:
+                    if (breach) {
+                        if (slot.rule.hold_ms == 0) {
+                            slot.phase = AlertPhase::Firing;
+                            on_transition(slot.rule, true, value);
+                        } else {
+                            slot.phase = AlertPhase::Pending;
+                            slot.phase_since_ms = now_ms;
+                        }
+                    }
+                    break;
+                case AlertPhase::Pending:
+                    if (!breach) {
+                        slot.phase = AlertPhase::Inactive;
+                    } else if (now_ms - slot.phase_since_ms >= slot.rule.hold_ms) {
+                        slot.phase = AlertPhase::Firing;
+                        on_transition(slot.rule, true, value);
+                    }
+                    break;
+                case AlertPhase::Firing:
+                    if (!breach) {
+                        if (slot.rule.hold_ms == 0) {
+                            slot.phase = AlertPhase::Inactive;
+                            on_transition(slot.rule, false, value);
+                        } else {
+                            slot.phase = AlertPhase::Clearing;
+                            slot.phase_since_ms = now_ms;
+                        }
+                    }
+                    break;
+                case AlertPhase::Clearing:
+                    if (breach) {
+                        slot.phase = AlertPhase::Firing;
+                    } else if (now_ms - slot.phase_since_ms >= slot.rule.hold_ms) {
+                        slot.phase = AlertPhase::Inactive;
+                        on_transition(slot.rule, false, value);
+                    }
+                    break;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        AlertRule rule;
+        AlertPhase phase;
+        int64_t phase_since_ms;
+    };
+
+    std::vector<Slot> rules_;
+};
+
+// Parses "metric>threshold" or "metric>threshold:seconds" (also '<'),
+// with the metric names the /series endpoint uses. Returns false on a
+// malformed spec.
+inline bool parse_alert_rule(const std::string& spec, AlertRule& rule) {
+    size_t op = spec.find_first_of("><");
+    if (op == std::string::npos || op == 0) return false;
+
+    if (!metric_from_name(std::string_view(spec).substr(0, op), rule.metric)) {
+        return false;
+    }
+
+    rule.comparison = spec[op] == '>' ? AlertComparison::Above
+                                      : AlertComparison::Below;
+
+    size_t colon = spec.find(':', op + 1);
+    try {
+        rule.threshold = std::stod(spec.substr(op + 1, colon - op - 1));
+        rule.hold_ms = colon == std::string::npos
+                           ? 0
+                           : std::stol(spec.substr(colon + 1)) * 1000;
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (rule.hold_ms < 0) return false;
+
+    rule.name = spec;
+    return true;
+}
+
+// The thresholds the hard-coded monitor-loop checks used to enforce.
+inline std::vector<AlertRule> default_alert_rules() {
+    std::vector<AlertRule> rules;
+    AlertRule rule;
+    parse_alert_rule("cpu>90", rule);
+    rules.push_back(rule);
+    parse_alert_rule("memory>90", rule);
+    rules.push_back(rule);
+    return rules;
+}
+
+#endif // ALERT_ENGINE_H
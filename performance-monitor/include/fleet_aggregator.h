@@ -0,0 +1,140 @@
+#ifndef FLEET_AGGREGATOR_H
+#define FLEET_AGGREGATOR_H
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "json_writer.h"
+#include "metric_registry.h"
+#include "performance_monitor.h"
+
+// Fleet-mode support: peer configuration, extraction of the scalar
+// series from a peer's /metrics body, and rendering of the merged
+// fleet view. The scrape loop itself (sockets, epoll) lives in
+// main.cpp next to the web server; this header is the pure logic so
+// the benchmark harness can exercise parse/render against fixtures.
+
+struct PeerConfig {
+    std::string label;  // "host:port" as given, echoed in the fleet view
+    std::string host;
+    int port;
+};
+
+// One peer's most recent scalar series, in METRIC_TABLE order.
+struct PeerSample {
+    bool up = false;
+    int64_t sampled_ms = 0;
+    double values[METRIC_SERIES_COUNT] = {};
+};
+
+// "host" or "host:port"; the port defaults to the server's own.
+inline bool parse_peer_spec(const std::string& spec, int default_port,
+                            PeerConfig& peer) {
+    if (spec.empty()) return false;
+    size_t colon = spec.rfind(':');
+    if (colon == std::string::npos) {
+        peer.host = spec;
+        peer.port = default_port;
+    } else {
+        peer.host = spec.substr(0, colon);
+        peer.port = std::atoi(spec.c_str() + colon + 1);
+        if (peer.host.empty() || peer.port <= 0 || peer.port > 65535) {
+            return false;
+        }
+    }
+    peer.label = peer.host + ":" + std::to_string(peer.port);
+    return true;
+}
+
+// Pulls the registry's series out of a peer /metrics body by scanning
+// for the quoted keys — the same targeted-extraction approach the
+// collectors use on /proc text, which sidesteps a JSON parser for the
+// five fixed fields we need. Returns false unless every series is
+// present, so a truncated or error body never half-fills a sample.
+inline bool parse_peer_metrics(const std::string& body, PeerSample& sample) {
+    for (size_t i = 0; i < METRIC_SERIES_COUNT; ++i) {
+        std::string key;
+        key.reserve(METRIC_TABLE[i].json_key.size() + 4);
+        key += '"';
+        key += METRIC_TABLE[i].json_key;
+        key += "\": ";
+        size_t pos = body.find(key);
+        if (pos == std::string::npos) return false;
+        sample.values[i] = std::strtod(body.c_str() + pos + key.size(), nullptr);
+    }
+    return true;
+}
+
+// Fleet view: per-host columns plus min/avg/max aggregates over the
+// hosts that answered their last scrape. Rendered once per scrape
+// round by the scraper thread; readers share the buffer.
+inline std::string format_fleet_json(const std::vector<PeerConfig>& peers,
+                                     const std::vector<PeerSample>& samples) {
+    std::string out;
+    out.reserve(256 + peers.size() * 192);
+    JsonWriter json(out);
+
+    size_t hosts_up = 0;
+    MetricAggregate aggregates[METRIC_SERIES_COUNT] = {};
+    for (const PeerSample& sample : samples) {
+        if (!sample.up) continue;
+        ++hosts_up;
+        for (size_t s = 0; s < METRIC_SERIES_COUNT; ++s) {
+            MetricAggregate& agg = aggregates[s];
+            double value = sample.values[s];
+            if (agg.count == 0) {
+                agg.min = agg.max = value;
+            } else {
+                if (value < agg.min) agg.min = value;
+                if (value > agg.max) agg.max = value;
+            }
+            agg.sum += value;
+            ++agg.count;
+        }
+    }
+
+    json.literal("{\n  \"hosts_total\": ");
+    json.append_uint(peers.size());
+    json.literal(",\n  \"hosts_up\": ");
+    json.append_uint(hosts_up);
+    json.literal(",\n  \"fleet\": {");
+    for (size_t s = 0; s < METRIC_SERIES_COUNT; ++s) {
+        const MetricAggregate& agg = aggregates[s];
+        if (s > 0) json.literal(", ");
+        json.literal("\"");
+        out += METRIC_TABLE[s].json_key;
+        json.literal("\": {\"min\": ");
+        json.append_fixed(agg.count ? agg.min : 0.0);
+        json.literal(", \"avg\": ");
+        json.append_fixed(agg.avg());
+        json.literal(", \"max\": ");
+        json.append_fixed(agg.count ? agg.max : 0.0);
+        json.literal("}");
+    }
+    json.literal("},\n  \"hosts\": [\n");
+
+    for (size_t i = 0; i < peers.size(); ++i) {
+        const PeerSample& sample = samples[i];
+        json.literal("    {\n      \"host\": ");
+        json.append_escaped(peers[i].label);
+        json.literal(",\n      \"up\": ");
+        out += sample.up ? "true" : "false";
+        json.literal(",\n      \"sampled_ms\": ");
+        json.append_int(sample.sampled_ms);
+        for (size_t s = 0; s < METRIC_SERIES_COUNT; ++s) {
+            json.literal(",\n      \"");
+            out += METRIC_TABLE[s].json_key;
+            json.literal("\": ");
+            json.append_fixed(sample.values[s]);
+        }
+        json.literal("\n    }");
+        if (i < peers.size() - 1) json.literal(",");
+        json.literal("\n");
+    }
+
+    json.literal("  ]\n}");
+    return out;
+}
+
+#endif // FLEET_AGGREGATOR_H
@@ -0,0 +1,261 @@
+#ifndef HISTORY_FILE_H
+#define HISTORY_FILE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "performance_monitor.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/sysinfo.h>
+    #include <unistd.h>
+
+    #include <chrono>
+#endif
+
+// Memory-mapped binary history log.
+//
+// Layout: a fixed header followed by fixed-size HistoryEntry records.
+// Appends are crash-safe by ordering: the record bytes are written (and
+// scheduled for writeback) before the header's committed_count is
+// advanced, so a torn tail record past committed_count is simply
+// ignored on recovery. The file grows in chunks up to a fixed cap —
+// one day of records at 1 Hz — and then appends wrap around, treating
+// the file as a ring: committed_count keeps rising, the slot is
+// count % capacity, and the oldest record is overwritten. The append
+// path itself is a memcpy into the mapping, no syscalls except the
+// occasional grow.
+//
+// Timestamps are milliseconds since boot, so a file written by a
+// previous boot is meaningless to this one; the header carries the
+// boot epoch and a mismatch (or any other validation failure) discards
+// the file and starts fresh rather than replaying alien timestamps
+// into the rollup tiers.
+//
+// Single writer (the monitor loop); readers use load_tail() on startup.
+class HistoryFile {
+public:
+    explicit HistoryFile(const std::string& path) : path_(path) {}
+
+    ~HistoryFile() { close_file(); }
+
+    HistoryFile(const HistoryFile&) = delete;
+    HistoryFile& operator=(const HistoryFile&) = delete;
+
+#ifdef _WIN32
+    // On-disk history is not wired up on Windows yet.
+    bool open_or_create() { return false; }
+    bool is_open() const { return false; }
+    uint64_t committed() const { return 0; }
+    bool append(const HistoryEntry&) { return false; }
+    size_t load_tail(size_t, std::vector<HistoryEntry>&) const { return 0; }
+    void close_file() {}
+#else
+    bool open_or_create() {
+        fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+
+        struct stat st {};
+        if (fstat(fd_, &st) < 0) {
+            close_file();
+            return false;
+        }
+
+        if (st.st_size == 0) {
+            return init_fresh();
+        }
+
+        // Existing file: validate and resume past the committed tail.
+        capacity_records_ =
+            (static_cast<size_t>(st.st_size) - sizeof(FileHeader)) / sizeof(HistoryEntry);
+        if (!remap(static_cast<size_t>(st.st_size))) {
+            close_file();
+            return false;
+        }
+
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(mapping_);
+        bool valid =
+            memcmp(header->magic, MAGIC, sizeof(header->magic)) == 0 &&
+            header->version == FORMAT_VERSION &&
+            header->record_size == sizeof(HistoryEntry) &&
+            capacity_records_ > 0 &&
+            capacity_records_ <= FILE_CAPACITY_RECORDS &&
+            (header->committed_count <= capacity_records_ ||
+             capacity_records_ == FILE_CAPACITY_RECORDS) &&
+            // Same tolerance as the collector-state file: the boot
+            // epoch is derived from uptime and can jitter a little.
+            std::abs(header->boot_epoch - current_boot_epoch()) <= 2;
+        if (!valid) {
+            // Unreadable or written by another boot/format: its
+            // since-boot timestamps mean nothing now. Start over.
+            if (ftruncate(fd_, 0) < 0) {
+                close_file();
+                return false;
+            }
+            return init_fresh();
+        }
+        return true;
+    }
+
+    bool is_open() const { return mapping_ != nullptr; }
+
+    uint64_t committed() const {
+        if (!is_open()) return 0;
+        return reinterpret_cast<const FileHeader*>(mapping_)->committed_count;
+    }
+
+    bool append(const HistoryEntry& entry) {
+        if (!is_open()) return false;
+
+        FileHeader* header = reinterpret_cast<FileHeader*>(mapping_);
+        uint64_t count = header->committed_count;
+        // Grow in chunks until the cap, then wrap in place.
+        if (count >= capacity_records_ && capacity_records_ < FILE_CAPACITY_RECORDS) {
+            size_t target = capacity_records_ + GROWTH_CHUNK_RECORDS;
+            if (target > FILE_CAPACITY_RECORDS) target = FILE_CAPACITY_RECORDS;
+            if (!grow_to(target)) return false;
+        }
+        header = reinterpret_cast<FileHeader*>(mapping_); // may have remapped
+
+        char* record = record_at(count % capacity_records_);
+        memcpy(record, &entry, sizeof(entry));
+        msync(page_of(record), page_span(record, sizeof(entry)), MS_ASYNC);
+
+        // Commit point: only advance the count once the record bytes are
+        // scheduled for writeback.
+        header->committed_count = count + 1;
+        msync(mapping_, sizeof(FileHeader), MS_ASYNC);
+        return true;
+    }
+
+    // Copies the last `count` committed records (oldest first).
+    size_t load_tail(size_t count, std::vector<HistoryEntry>& out) const {
+        if (!is_open()) return 0;
+
+        uint64_t committed_count =
+            reinterpret_cast<const FileHeader*>(mapping_)->committed_count;
+        uint64_t available = committed_count < capacity_records_
+                                 ? committed_count
+                                 : capacity_records_;
+        size_t items = (count == 0 || count > available)
+                           ? static_cast<size_t>(available)
+                           : count;
+
+        out.reserve(out.size() + items);
+        for (uint64_t i = committed_count - items; i != committed_count; ++i) {
+            HistoryEntry entry;
+            memcpy(&entry, record_at(i % capacity_records_), sizeof(entry));
+            out.push_back(entry);
+        }
+        return items;
+    }
+
+    void close_file() {
+        if (mapping_) {
+            msync(mapping_, mapped_size_, MS_SYNC);
+            munmap(mapping_, mapped_size_);
+            mapping_ = nullptr;
+            mapped_size_ = 0;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+#endif
+
+private:
+    std::string path_;
+
+#ifndef _WIN32
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t committed_count;  // total ever appended; slot = count % capacity
+        int64_t boot_epoch;        // seconds; identifies the boot
+    };
+
+    static constexpr const char* MAGIC = "PMHIST\0";
+    static const uint32_t FORMAT_VERSION = 2;
+    static const size_t GROWTH_CHUNK_RECORDS = 4096;
+    // Size cap: one day at 1 Hz, ~4 MB. Past this the file is a ring.
+    static const size_t FILE_CAPACITY_RECORDS = 86400;
+
+    static int64_t current_boot_epoch() {
+        struct sysinfo si;
+        sysinfo(&si);
+        auto now = std::chrono::system_clock::now();
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   now.time_since_epoch()).count() - si.uptime;
+    }
+
+    bool init_fresh() {
+        if (!grow_to(GROWTH_CHUNK_RECORDS)) {
+            close_file();
+            return false;
+        }
+        FileHeader header{};
+        memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = FORMAT_VERSION;
+        header.record_size = sizeof(HistoryEntry);
+        header.committed_count = 0;
+        header.boot_epoch = current_boot_epoch();
+        memcpy(mapping_, &header, sizeof(header));
+        msync(mapping_, sizeof(FileHeader), MS_ASYNC);
+        return true;
+    }
+
+    char* record_at(uint64_t index) const {
+        return mapping_ + sizeof(FileHeader) + index * sizeof(HistoryEntry);
+    }
+
+    char* page_of(char* address) const {
+        static const uintptr_t page_mask = ~static_cast<uintptr_t>(getpagesize() - 1);
+        return reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(address) & page_mask);
+    }
+
+    size_t page_span(char* address, size_t length) const {
+        return static_cast<size_t>((address + length) - page_of(address));
+    }
+
+    bool grow_to(size_t records) {
+        size_t new_size = sizeof(FileHeader) + records * sizeof(HistoryEntry);
+        if (ftruncate(fd_, static_cast<off_t>(new_size)) < 0) return false;
+        if (!remap(new_size)) return false;
+        capacity_records_ = records;
+        return true;
+    }
+
+    bool remap(size_t size) {
+        if (mapping_) {
+            munmap(mapping_, mapped_size_);
+            mapping_ = nullptr;
+        }
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            mapped_size_ = 0;
+            return false;
+        }
+        // Prefetch the file pages now so the startup tail load and the
+        // first flushes don't fault on demand.
+        madvise(mapped, size, MADV_WILLNEED);
+        mapping_ = static_cast<char*>(mapped);
+        mapped_size_ = size;
+        return true;
+    }
+
+    int fd_ = -1;
+    char* mapping_ = nullptr;
+    size_t mapped_size_ = 0;
+    size_t capacity_records_ = 0;
+#endif
+};
+
+#endif // HISTORY_FILE_H
@@ -0,0 +1,118 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Minimal JSON emitter for the hot serialization paths.
+//
+// Writes into a caller-provided growable string: constant skeleton
+// fragments are appended as raw byte runs (compile-time lengths, no
+// scanning), integers use a two-digit lookup table, and doubles are
+// formatted as fixed-point with two decimals via integer math — no
+// ostringstream, no locale machinery, no per-value allocation. Output
+// matches what the std::fixed/setprecision(2) formatters produced.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    // Constant skeleton fragment; length resolved at compile time.
+    template <size_t N>
+    void literal(const char (&text)[N]) {
+        out_.append(text, N - 1);
+    }
+
+    void append_uint(uint64_t value) {
+        char buffer[20];
+        char* end = buffer + sizeof(buffer);
+        char* p = end;
+
+        while (value >= 100) {
+            const char* pair = digit_pairs() + (value % 100) * 2;
+            p -= 2;
+            p[0] = pair[0];
+            p[1] = pair[1];
+            value /= 100;
+        }
+        if (value >= 10) {
+            const char* pair = digit_pairs() + value * 2;
+            p -= 2;
+            p[0] = pair[0];
+            p[1] = pair[1];
+        } else {
+            *--p = static_cast<char>('0' + value);
+        }
+
+        out_.append(p, static_cast<size_t>(end - p));
+    }
+
+    void append_int(int64_t value) {
+        if (value < 0) {
+            out_.push_back('-');
+            append_uint(static_cast<uint64_t>(-value));
+        } else {
+            append_uint(static_cast<uint64_t>(value));
+        }
+    }
+
+    // Fixed-point with exactly two decimals, matching setprecision(2).
+    void append_fixed(double value) {
+        if (value < 0.0) {
+            out_.push_back('-');
+            value = -value;
+        }
+
+        // Round to hundredths in integer space.
+        uint64_t scaled = static_cast<uint64_t>(value * 100.0 + 0.5);
+        append_uint(scaled / 100);
+
+        const char* pair = digit_pairs() + (scaled % 100) * 2;
+        char fraction[3] = {'.', pair[0], pair[1]};
+        out_.append(fraction, 3);
+    }
+
+    // String value with the escapes JSON requires; metric payload
+    // strings (process names) are overwhelmingly escape-free.
+    void append_escaped(const std::string& text) {
+        append_escaped(text.data(), text.size());
+    }
+
+    void append_escaped(const char* text, size_t length) {
+        out_.push_back('"');
+        for (size_t i = 0; i < length; ++i) {
+            char c = text[i];
+            switch (c) {
+                case '"':  literal("\\\""); break;
+                case '\\': literal("\\\\"); break;
+                case '\n': literal("\\n"); break;
+                case '\r': literal("\\r"); break;
+                case '\t': literal("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        literal("\\u00");
+                        const char* hex = "0123456789abcdef";
+                        out_.push_back(hex[(c >> 4) & 0xf]);
+                        out_.push_back(hex[c & 0xf]);
+                    } else {
+                        out_.push_back(c);
+                    }
+            }
+        }
+        out_.push_back('"');
+    }
+
+private:
+    static const char* digit_pairs() {
+        static const char pairs[] =
+            "00010203040506070809101112131415161718192021222324"
+            "25262728293031323334353637383940414243444546474849"
+            "50515253545556575859606162636465666768697071727374"
+            "75767778798081828384858687888990919293949596979899";
+        return pairs;
+    }
+
+    std::string& out_;
+};
+
+#endif // JSON_WRITER_H
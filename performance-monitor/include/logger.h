@@ -0,0 +1,191 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Asynchronous logging backend shared by all Logger instances.
+//
+// Producers format into a fixed-size slot of a bounded lock-free MPMC
+// ring (Vyukov-style sequence-per-cell queue) and never block or touch
+// the heap; a dedicated flush thread drains the ring, renders the
+// timestamp and writes to stdout. When the ring is full the message is
+// dropped and counted rather than stalling the caller — a collector
+// tick is worth more than a log line.
+class LoggerBackend {
+public:
+    enum class Level : uint8_t { Info, Warn, Error };
+
+    static LoggerBackend& instance() {
+        static LoggerBackend backend;
+        return backend;
+    }
+
+    void log(Level level, const std::string& component, const std::string& message) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & (RING_SIZE - 1)];
+            uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    fill_cell(cell, level, component, message);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+                // CAS lost a race; pos was reloaded, retry.
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return; // ring full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint64_t dropped_count() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    LoggerBackend(const LoggerBackend&) = delete;
+    LoggerBackend& operator=(const LoggerBackend&) = delete;
+
+private:
+    static const size_t RING_SIZE = 1024;      // power of two
+    static const size_t MAX_TEXT_SIZE = 448;   // component + message, truncated
+
+    struct Cell {
+        std::atomic<uint64_t> sequence{0};
+        std::chrono::system_clock::time_point timestamp;
+        Level level;
+        char text[MAX_TEXT_SIZE];
+    };
+
+    LoggerBackend() {
+        for (size_t i = 0; i < RING_SIZE; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        flush_thread_ = std::thread(&LoggerBackend::flush_loop, this);
+    }
+
+    ~LoggerBackend() {
+        stopping_.store(true);
+        if (flush_thread_.joinable()) {
+            flush_thread_.join();
+        }
+        drain(); // whatever arrived after the flush thread's last pass
+    }
+
+    static void fill_cell(Cell& cell, Level level, const std::string& component,
+                          const std::string& message) {
+        cell.timestamp = std::chrono::system_clock::now();
+        cell.level = level;
+        int written = snprintf(cell.text, MAX_TEXT_SIZE, "[%s] %s",
+                               component.c_str(), message.c_str());
+        if (written < 0) {
+            cell.text[0] = '\0';
+        }
+    }
+
+    // Single consumer: only the flush thread (and the destructor, after
+    // joining it) calls this.
+    bool pop(Cell& out) {
+        uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & (RING_SIZE - 1)];
+        uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false; // empty
+        }
+
+        out.timestamp = cell.timestamp;
+        out.level = cell.level;
+        memcpy(out.text, cell.text, MAX_TEXT_SIZE);
+        cell.sequence.store(pos + RING_SIZE, std::memory_order_release);
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void flush_loop() {
+        while (!stopping_.load()) {
+            if (!drain()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        }
+    }
+
+    bool drain() {
+        Cell cell;
+        bool wrote_any = false;
+        while (pop(cell)) {
+            write_record(cell);
+            wrote_any = true;
+        }
+
+        uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::cout << "[WARN] [Logger] dropped " << dropped
+                      << " log messages (ring full)\n";
+            wrote_any = true;
+        }
+
+        if (wrote_any) {
+            std::cout.flush();
+        }
+        return wrote_any;
+    }
+
+    static void write_record(const Cell& cell) {
+        std::time_t time = std::chrono::system_clock::to_time_t(cell.timestamp);
+        std::tm tm_buf{};
+#ifdef _WIN32
+        localtime_s(&tm_buf, &time);
+#else
+        localtime_r(&time, &tm_buf);
+#endif
+        const char* level = cell.level == Level::Info   ? "INFO"
+                            : cell.level == Level::Warn ? "WARN"
+                                                        : "ERROR";
+        std::cout << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S")
+                  << " [" << level << "] " << cell.text << '\n';
+    }
+
+    Cell cells_[RING_SIZE];
+    std::atomic<uint64_t> enqueue_pos_{0};
+    std::atomic<uint64_t> dequeue_pos_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread flush_thread_;
+};
+
+// Component-tagged front end; all instances funnel into LoggerBackend.
+class Logger {
+public:
+    explicit Logger(const std::string& component) : component_(component) {}
+
+    void info(const std::string& message) {
+        LoggerBackend::instance().log(LoggerBackend::Level::Info, component_, message);
+    }
+
+    void warn(const std::string& message) {
+        LoggerBackend::instance().log(LoggerBackend::Level::Warn, component_, message);
+    }
+
+    void error(const std::string& message) {
+        LoggerBackend::instance().log(LoggerBackend::Level::Error, component_, message);
+    }
+
+private:
+    std::string component_;
+};
+
+#endif // LOGGER_H
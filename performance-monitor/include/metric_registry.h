@@ -0,0 +1,71 @@
+#ifndef METRIC_REGISTRY_H
+#define METRIC_REGISTRY_H
+
+#include <cstddef>
+#include <string_view>
+
+#include "performance_monitor.h"
+
+// Compile-time registry of the scalar metric series. Each series is
+// described once — lookup name, JSON key, Prometheus exposition
+// skeleton, and the struct fields it reads — and the serializers, the
+// binary column encoder, and name-based dispatch all derive from this
+// table. Adding a series is one MetricId value plus one descriptor
+// line; nothing downstream grows a new string literal or switch case.
+struct MetricDescriptor {
+    MetricId id;
+    std::string_view name;      // lookup key for /series and --alert specs
+    std::string_view json_key;  // field name in JSON payloads
+    // "# HELP ...\n# TYPE ...\n<name> " as one pre-concatenated
+    // literal so a scrape appends the whole skeleton in one byte run.
+    std::string_view prometheus_block;
+    double MetricSnapshot::*snapshot_field;
+    double HistoryEntry::*history_field;
+};
+
+constexpr MetricDescriptor METRIC_TABLE[METRIC_SERIES_COUNT] = {
+    {MetricId::CpuUsage, "cpu", "cpu_usage",
+     "# HELP perfmon_cpu_usage_percent Aggregate CPU utilization.\n"
+     "# TYPE perfmon_cpu_usage_percent gauge\n"
+     "perfmon_cpu_usage_percent ",
+     &MetricSnapshot::cpu_usage, &HistoryEntry::cpu_usage},
+    {MetricId::MemoryUsage, "memory", "memory_usage",
+     "# HELP perfmon_memory_usage_percent Physical memory in use.\n"
+     "# TYPE perfmon_memory_usage_percent gauge\n"
+     "perfmon_memory_usage_percent ",
+     &MetricSnapshot::memory_usage, &HistoryEntry::memory_usage},
+    {MetricId::DiskUsage, "disk", "disk_usage",
+     "# HELP perfmon_disk_usage_percent Root filesystem space in use.\n"
+     "# TYPE perfmon_disk_usage_percent gauge\n"
+     "perfmon_disk_usage_percent ",
+     &MetricSnapshot::disk_usage, &HistoryEntry::disk_usage},
+    {MetricId::NetworkRx, "network_rx", "network_rx",
+     "# HELP perfmon_network_receive_bps Receive throughput, bytes per second.\n"
+     "# TYPE perfmon_network_receive_bps gauge\n"
+     "perfmon_network_receive_bps ",
+     &MetricSnapshot::network_rx, &HistoryEntry::network_rx},
+    {MetricId::NetworkTx, "network_tx", "network_tx",
+     "# HELP perfmon_network_transmit_bps Transmit throughput, bytes per second.\n"
+     "# TYPE perfmon_network_transmit_bps gauge\n"
+     "perfmon_network_transmit_bps ",
+     &MetricSnapshot::network_tx, &HistoryEntry::network_tx},
+};
+
+constexpr const MetricDescriptor& metric_descriptor(MetricId id) {
+    return METRIC_TABLE[static_cast<size_t>(id)];
+}
+
+// Index-based dispatch for the name-keyed entry points (/series paths,
+// --alert specs). One linear scan over five descriptors; no caller is
+// hot enough to warrant more.
+inline bool metric_from_name(std::string_view name, MetricId& id) {
+    for (const MetricDescriptor& metric : METRIC_TABLE) {
+        if (name == metric.name) {
+            id = metric.id;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // METRIC_REGISTRY_H
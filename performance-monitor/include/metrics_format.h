@@ -0,0 +1,235 @@
+#ifndef METRICS_FORMAT_H
+#define METRICS_FORMAT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "json_writer.h"
+#include "metric_registry.h"
+#include "performance_monitor.h"
+
+// JSON rendering for the HTTP endpoints, split out from the server so
+// the benchmark harness can measure serialization against fixture data.
+
+inline std::string format_metrics_json(const MetricSnapshot& snapshot) {
+    const ProcessTable* processes = snapshot.top_processes.get();
+    size_t process_count = processes ? processes->size() : 0;
+
+    std::string out;
+    out.reserve(256 + process_count * 160);
+    JsonWriter json(out);
+
+    json.literal("{\n  \"timestamp\": ");
+    json.append_int(std::chrono::duration_cast<std::chrono::milliseconds>(
+            snapshot.timestamp.time_since_epoch()).count());
+    json.literal(",\n  \"cpu_usage\": ");
+    json.append_fixed(snapshot.cpu_usage);
+    if (!snapshot.per_core_cpu.empty()) {
+        double max_core = *std::max_element(snapshot.per_core_cpu.begin(),
+                                            snapshot.per_core_cpu.end());
+        json.literal(",\n  \"cpu_max_core\": ");
+        json.append_fixed(max_core);
+        json.literal(",\n  \"cpu_per_core\": [");
+        for (size_t i = 0; i < snapshot.per_core_cpu.size(); ++i) {
+            if (i > 0) json.literal(", ");
+            json.append_fixed(snapshot.per_core_cpu[i]);
+        }
+        json.literal("]");
+    }
+    if (snapshot.cgroup_cpu_usage >= 0.0) {
+        json.literal(",\n  \"cgroup_cpu_usage\": ");
+        json.append_fixed(snapshot.cgroup_cpu_usage);
+    }
+    json.literal(",\n  \"memory_usage\": ");
+    json.append_fixed(snapshot.memory_usage);
+    json.literal(",\n  \"disk_usage\": ");
+    json.append_fixed(snapshot.disk_usage);
+    json.literal(",\n  \"network_rx\": ");
+    json.append_fixed(snapshot.network_rx);
+    json.literal(",\n  \"network_tx\": ");
+    json.append_fixed(snapshot.network_tx);
+    if (!snapshot.interface_rates.empty()) {
+        json.literal(",\n  \"interfaces\": {");
+        for (size_t i = 0; i < snapshot.interface_rates.size(); ++i) {
+            const auto& iface = snapshot.interface_rates[i];
+            if (i > 0) json.literal(", ");
+            json.append_escaped(iface.name);
+            json.literal(": {\"rx_bps\": ");
+            json.append_fixed(iface.rx_bps);
+            json.literal(", \"tx_bps\": ");
+            json.append_fixed(iface.tx_bps);
+            json.literal("}");
+        }
+        json.literal("}");
+    }
+    json.literal(",\n  \"top_processes\": [\n");
+
+    for (size_t i = 0; i < process_count; ++i) {
+        const ProcessRecord& proc = processes->record(i);
+        json.literal("    {\n      \"pid\": ");
+        json.append_uint(proc.pid);
+        json.literal(",\n      \"name\": ");
+        json.append_escaped(processes->name_data(proc), proc.name_length);
+        json.literal(",\n      \"cpu_percent\": ");
+        json.append_fixed(proc.cpu_percent);
+        json.literal(",\n      \"memory_bytes\": ");
+        json.append_uint(proc.memory_bytes);
+        json.literal(",\n      \"pss_bytes\": ");
+        json.append_uint(proc.pss_bytes);
+        json.literal(",\n      \"io_read_bytes\": ");
+        json.append_uint(proc.io_read_bytes);
+        json.literal(",\n      \"io_write_bytes\": ");
+        json.append_uint(proc.io_write_bytes);
+        json.literal(",\n      \"status\": ");
+        const char* label = process_state_label(proc.state);
+        json.append_escaped(label, std::strlen(label));
+        json.literal("\n    }");
+        if (i < process_count - 1) json.literal(",");
+        json.literal("\n");
+    }
+
+    json.literal("  ]\n}");
+    return out;
+}
+
+// Prometheus text exposition rendered straight from the snapshot: the
+// HELP/TYPE/name skeleton of every gauge is a compile-time literal
+// appended as one byte run, so a scrape costs a few memcpys plus the
+// numeric conversions — no per-scrape metric-name string building.
+// The scalar series come from the registry; the labelled gauges
+// (per-core, per-interface) and the conditional cgroup gauge keep
+// their hand-written blocks below.
+// JsonWriter is only used here as the fast number formatter.
+inline std::string format_prometheus_text(const MetricSnapshot& snapshot) {
+    std::string out;
+    out.reserve(1024 + snapshot.per_core_cpu.size() * 48 +
+                snapshot.interface_rates.size() * 128);
+    JsonWriter text(out);
+
+    for (const MetricDescriptor& metric : METRIC_TABLE) {
+        out += metric.prometheus_block;
+        text.append_fixed(snapshot.*metric.snapshot_field);
+        text.literal("\n");
+    }
+
+    if (!snapshot.per_core_cpu.empty()) {
+        text.literal(
+            "# HELP perfmon_cpu_core_usage_percent Per-core CPU utilization.\n"
+            "# TYPE perfmon_cpu_core_usage_percent gauge\n");
+        for (size_t i = 0; i < snapshot.per_core_cpu.size(); ++i) {
+            text.literal("perfmon_cpu_core_usage_percent{core=\"");
+            text.append_uint(i);
+            text.literal("\"} ");
+            text.append_fixed(snapshot.per_core_cpu[i]);
+            text.literal("\n");
+        }
+    }
+
+    if (snapshot.cgroup_cpu_usage >= 0.0) {
+        text.literal(
+            "# HELP perfmon_cgroup_cpu_usage_percent CPU utilization of this cgroup.\n"
+            "# TYPE perfmon_cgroup_cpu_usage_percent gauge\n"
+            "perfmon_cgroup_cpu_usage_percent ");
+        text.append_fixed(snapshot.cgroup_cpu_usage);
+        text.literal("\n");
+    }
+
+    if (!snapshot.interface_rates.empty()) {
+        text.literal(
+            "# HELP perfmon_interface_receive_bps Per-interface receive throughput.\n"
+            "# TYPE perfmon_interface_receive_bps gauge\n");
+        for (const auto& iface : snapshot.interface_rates) {
+            text.literal("perfmon_interface_receive_bps{interface=\"");
+            out += iface.name;
+            text.literal("\"} ");
+            text.append_fixed(iface.rx_bps);
+            text.literal("\n");
+        }
+        text.literal(
+            "# HELP perfmon_interface_transmit_bps Per-interface transmit throughput.\n"
+            "# TYPE perfmon_interface_transmit_bps gauge\n");
+        for (const auto& iface : snapshot.interface_rates) {
+            text.literal("perfmon_interface_transmit_bps{interface=\"");
+            out += iface.name;
+            text.literal("\"} ");
+            text.append_fixed(iface.tx_bps);
+            text.literal("\n");
+        }
+    }
+
+    return out;
+}
+
+inline std::string format_history_json(const std::vector<HistoryEntry>& history) {
+    std::string out;
+    out.reserve(32 + history.size() * 128);
+    JsonWriter json(out);
+
+    json.literal("{\n  \"data\": [\n");
+
+    for (size_t i = 0; i < history.size(); ++i) {
+        const auto& snapshot = history[i];
+        json.literal("    {\n      \"timestamp\": ");
+        json.append_int(snapshot.timestamp_ms);
+        for (const MetricDescriptor& metric : METRIC_TABLE) {
+            json.literal(",\n      \"");
+            out += metric.json_key;
+            json.literal("\": ");
+            json.append_fixed(snapshot.*metric.history_field);
+        }
+        json.literal("\n    }");
+        if (i < history.size() - 1) json.literal(",");
+        json.literal("\n");
+    }
+
+    json.literal("  ],\n  \"count\": ");
+    json.append_uint(history.size());
+    json.literal("\n}");
+    return out;
+}
+
+inline std::string format_rollup_history_json(
+        const std::string& resolution,
+        const std::vector<AggregateEntry>& history) {
+    std::string out;
+    out.reserve(64 + history.size() * 384);
+    JsonWriter json(out);
+
+    json.literal("{\n  \"resolution\": ");
+    json.append_escaped(resolution);
+    json.literal(",\n  \"data\": [\n");
+
+    for (size_t i = 0; i < history.size(); ++i) {
+        const auto& bucket = history[i];
+        json.literal("    {\n      \"timestamp\": ");
+        json.append_int(bucket.bucket_start_ms);
+        json.literal(",\n");
+        for (size_t s = 0; s < METRIC_SERIES_COUNT; ++s) {
+            const MetricAggregate& agg = bucket.series[s];
+            json.literal("      \"");
+            out += METRIC_TABLE[s].json_key;
+            json.literal("\": {\"min\": ");
+            json.append_fixed(agg.min);
+            json.literal(", \"avg\": ");
+            json.append_fixed(agg.avg());
+            json.literal(", \"max\": ");
+            json.append_fixed(agg.max);
+            json.literal("}");
+            if (s < METRIC_SERIES_COUNT - 1) json.literal(",");
+            json.literal("\n");
+        }
+        json.literal("    }");
+        if (i < history.size() - 1) json.literal(",");
+        json.literal("\n");
+    }
+
+    json.literal("  ],\n  \"count\": ");
+    json.append_uint(history.size());
+    json.literal("\n}");
+    return out;
+}
+
+#endif // METRICS_FORMAT_H
@@ -0,0 +1,429 @@
+#ifndef PERFORMANCE_MONITOR_H
+#define PERFORMANCE_MONITOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Process states as a small enum instead of per-record strings.
+enum class ProcessState : uint8_t {
+    Running,
+    Sleeping,
+    DiskSleep,
+    Zombie,
+    Stopped,
+    Idle,
+    Unknown,
+};
+
+inline const char* process_state_label(ProcessState state) {
+    switch (state) {
+        case ProcessState::Running:   return "running";
+        case ProcessState::Sleeping:  return "sleeping";
+        case ProcessState::DiskSleep: return "disk-sleep";
+        case ProcessState::Zombie:    return "zombie";
+        case ProcessState::Stopped:   return "stopped";
+        case ProcessState::Idle:      return "idle";
+        default:                      return "unknown";
+    }
+}
+
+// One process row. The name is not owned here: it lives in the owning
+// ProcessTable's string arena, so records are plain scalars that sort
+// and copy without touching the heap.
+struct ProcessRecord {
+    uint32_t pid;
+    uint32_t name_offset;
+    uint32_t name_length;
+    double cpu_percent;
+    uint64_t memory_bytes;
+    ProcessState state;
+    // Filled by the expensive per-pid enrichment pass, which only runs
+    // for the final top-N; zero when unreadable (e.g. permissions).
+    uint64_t pss_bytes = 0;
+    uint64_t io_read_bytes = 0;
+    uint64_t io_write_bytes = 0;
+};
+
+// One scan's worth of process rows plus a bump-allocated string arena
+// for the names. clear() keeps both buffers' capacity, so a recycled
+// table reaches zero malloc/free per scan once warmed up.
+class ProcessTable {
+public:
+    void clear() {
+        records_.clear();
+        arena_.clear();
+    }
+
+    void add(uint32_t pid, const char* name, size_t name_length,
+             double cpu_percent, uint64_t memory_bytes, ProcessState state) {
+        ProcessRecord record;
+        record.pid = pid;
+        record.name_offset = static_cast<uint32_t>(arena_.size());
+        record.name_length = static_cast<uint32_t>(name_length);
+        record.cpu_percent = cpu_percent;
+        record.memory_bytes = memory_bytes;
+        record.state = state;
+        arena_.append(name, name_length);
+        records_.push_back(record);
+    }
+
+    size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+
+    const ProcessRecord& record(size_t index) const { return records_[index]; }
+    const char* name_data(const ProcessRecord& record) const {
+        return arena_.data() + record.name_offset;
+    }
+
+    // Mutable record access for sorting; the arena is unaffected since
+    // records carry offsets, not pointers.
+    std::vector<ProcessRecord>& records() { return records_; }
+
+    void reserve(size_t record_count, size_t arena_bytes) {
+        records_.reserve(record_count);
+        arena_.reserve(arena_bytes);
+    }
+
+    void truncate(size_t count) {
+        if (count < records_.size()) {
+            records_.resize(count);
+        }
+    }
+
+private:
+    std::vector<ProcessRecord> records_;
+    std::string arena_;
+};
+
+// Per-interface throughput for one sampling window.
+struct InterfaceRate {
+    std::string name;
+    double rx_bps = 0.0;
+    double tx_bps = 0.0;
+};
+
+struct MetricSnapshot {
+    std::chrono::steady_clock::time_point timestamp;
+    double cpu_usage = 0.0;
+    double memory_usage = 0.0;
+    double disk_usage = 0.0;
+    double network_rx = 0.0;
+    double network_tx = 0.0;
+    double cgroup_cpu_usage = -1.0;  // cgroup-v2 usage; -1 when unavailable
+    std::vector<double> per_core_cpu;
+    std::vector<InterfaceRate> interface_rates;
+    // Shared with the process worker's table pool; copying a snapshot
+    // bumps a refcount instead of duplicating names.
+    std::shared_ptr<const ProcessTable> top_processes;
+};
+
+// One history sample. Plain scalars only so ring slots can be copied
+// without touching the heap; process detail stays out of the history.
+struct HistoryEntry {
+    int64_t timestamp_ms;
+    double cpu_usage;
+    double memory_usage;
+    double disk_usage;
+    double network_rx;
+    double network_tx;
+};
+
+// Fixed-capacity circular buffer for metric history. EntryT must be a
+// plain-scalar struct so slot copies never touch the heap.
+//
+// Single producer (the monitor loop), any number of readers. Each slot
+// carries its own sequence counter (per-slot seqlock): the producer bumps
+// it to an odd value before writing and an even value after, and never
+// blocks behind readers. Readers copy a slot and retry if the counter
+// changed underneath them, which only happens if the producer lapped the
+// whole buffer mid-copy. All storage is allocated once up front.
+template <typename EntryT>
+class MetricRing {
+public:
+    explicit MetricRing(size_t capacity)
+        : slots_(capacity), capacity_(capacity) {}
+
+    MetricRing(const MetricRing&) = delete;
+    MetricRing& operator=(const MetricRing&) = delete;
+
+    // Producer side. Must only be called from one thread.
+    void push(const EntryT& entry) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[head % capacity_];
+
+        slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_release); // now odd: write in progress
+        slot.entry = entry;
+        slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_release); // even again: stable
+
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    size_t size() const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        return head < capacity_ ? static_cast<size_t>(head) : capacity_;
+    }
+
+    // Copies up to `count` of the most recent entries, oldest first.
+    // Zero allocation beyond the caller's vector reserve.
+    std::vector<EntryT> read(size_t count = 0) const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        size_t available = head < capacity_ ? static_cast<size_t>(head) : capacity_;
+        size_t items = (count == 0 || count > available) ? available : count;
+
+        std::vector<EntryT> out;
+        out.reserve(items);
+
+        for (uint64_t i = head - items; i != head; ++i) {
+            const Slot& slot = slots_[i % capacity_];
+            EntryT entry;
+
+            // Seqlock read: retry while the producer is mid-write or has
+            // overwritten the slot between our two sequence reads.
+            uint64_t seq_before, seq_after;
+            do {
+                seq_before = slot.sequence.load(std::memory_order_acquire);
+                entry = slot.entry;
+                seq_after = slot.sequence.load(std::memory_order_acquire);
+            } while (seq_before != seq_after || (seq_before & 1) != 0);
+
+            out.push_back(entry);
+        }
+
+        return out;
+    }
+
+    // Raw backing storage, for placement advice and pre-faulting at
+    // startup, before any reader or writer thread exists.
+    void* storage() { return slots_.data(); }
+    size_t storage_bytes() const { return slots_.size() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        EntryT entry{};
+    };
+
+    std::vector<Slot> slots_;
+    size_t capacity_;
+    std::atomic<uint64_t> head_{0}; // total entries ever pushed
+};
+
+using MetricHistoryRing = MetricRing<HistoryEntry>;
+
+// Per-collector sampling intervals. Cheap collectors can run at high
+// frequency without paying for the process-table scan every tick.
+struct SamplingConfig {
+    std::chrono::milliseconds cpu_memory_interval{250};
+    std::chrono::milliseconds disk_interval{1000};
+    std::chrono::milliseconds network_interval{1000};
+    std::chrono::milliseconds process_interval{10000};
+    std::chrono::milliseconds history_interval{1000};
+    // The monitor's own CPU share (percent of one core) above which
+    // the governor starts shedding collection detail.
+    double self_cpu_budget_percent = 0.5;
+};
+
+// Identifies one scalar metric series held by MetricSeriesStore.
+enum class MetricId {
+    CpuUsage = 0,
+    MemoryUsage,
+    DiskUsage,
+    NetworkRx,
+    NetworkTx,
+};
+
+const size_t METRIC_SERIES_COUNT = 5;
+
+// Columnar (struct-of-arrays) history store: one contiguous circular
+// array per metric series plus a timestamp column. A trend query for a
+// single series is then a sequential scan of one column instead of
+// striding over interleaved snapshots.
+//
+// Same concurrency contract as MetricHistoryRing: one producer (the
+// monitor loop), many readers. A store-wide seqlock guards the columns;
+// at one write per sampling tick a reader copying a few KB practically
+// never retries.
+class MetricSeriesStore {
+public:
+    explicit MetricSeriesStore(size_t capacity)
+        : capacity_(capacity), timestamps_(capacity, 0) {
+        for (auto& column : columns_) {
+            column.assign(capacity, 0.0);
+        }
+    }
+
+    MetricSeriesStore(const MetricSeriesStore&) = delete;
+    MetricSeriesStore& operator=(const MetricSeriesStore&) = delete;
+
+    // Producer side. Must only be called from one thread.
+    void push_row(const HistoryEntry& entry) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t slot = head % capacity_;
+
+        write_begin();
+        timestamps_[slot] = entry.timestamp_ms;
+        columns_[static_cast<size_t>(MetricId::CpuUsage)][slot] = entry.cpu_usage;
+        columns_[static_cast<size_t>(MetricId::MemoryUsage)][slot] = entry.memory_usage;
+        columns_[static_cast<size_t>(MetricId::DiskUsage)][slot] = entry.disk_usage;
+        columns_[static_cast<size_t>(MetricId::NetworkRx)][slot] = entry.network_rx;
+        columns_[static_cast<size_t>(MetricId::NetworkTx)][slot] = entry.network_tx;
+        write_end();
+
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    size_t size() const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        return head < capacity_ ? static_cast<size_t>(head) : capacity_;
+    }
+
+    // Copies up to `count` of the most recent values of one series,
+    // oldest first.
+    std::vector<double> get_series(MetricId id, size_t count = 0) const {
+        std::vector<double> out;
+        read_column(columns_[static_cast<size_t>(id)], count, out);
+        return out;
+    }
+
+    // Timestamp column matching get_series() for the same count.
+    std::vector<int64_t> get_timestamps(size_t count = 0) const {
+        std::vector<int64_t> out;
+        read_column(timestamps_, count, out);
+        return out;
+    }
+
+    // Visits each backing column, for placement advice and
+    // pre-faulting at startup, before any reader thread exists.
+    template <typename Fn>
+    void for_each_storage(Fn fn) {
+        for (auto& column : columns_) {
+            fn(column.data(), column.size() * sizeof(double));
+        }
+        fn(timestamps_.data(), timestamps_.size() * sizeof(int64_t));
+    }
+
+private:
+    void write_begin() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release); // odd: write in progress
+    }
+
+    void write_end() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release); // even: stable
+    }
+
+    template <typename T>
+    void read_column(const std::vector<T>& column, size_t count,
+                     std::vector<T>& out) const {
+        uint64_t seq_before, seq_after;
+        do {
+            seq_before = sequence_.load(std::memory_order_acquire);
+            // Writer mid-tick: force a retry. seq_after must be set
+            // before the continue reaches the loop condition.
+            seq_after = seq_before + 1;
+            if ((seq_before & 1) != 0) continue;
+
+            uint64_t head = head_.load(std::memory_order_acquire);
+            size_t available = head < capacity_ ? static_cast<size_t>(head) : capacity_;
+            size_t items = (count == 0 || count > available) ? available : count;
+
+            out.clear();
+            out.reserve(items);
+            for (uint64_t i = head - items; i != head; ++i) {
+                out.push_back(column[i % capacity_]);
+            }
+
+            seq_after = sequence_.load(std::memory_order_acquire);
+        } while (seq_before != seq_after || (seq_before & 1) != 0);
+    }
+
+    size_t capacity_;
+    std::array<std::vector<double>, METRIC_SERIES_COUNT> columns_;
+    std::vector<int64_t> timestamps_;
+    std::atomic<uint64_t> sequence_{0}; // store-wide seqlock
+    std::atomic<uint64_t> head_{0};     // total rows ever pushed
+};
+
+// Retention tiers for history queries.
+enum class HistoryResolution { Raw, Minute, Hour };
+
+// min/avg/max rollup of one metric series over one time bucket.
+struct MetricAggregate {
+    double min;
+    double max;
+    double sum;
+    uint32_t count;
+
+    double avg() const { return count > 0 ? sum / count : 0.0; }
+};
+
+// One pre-aggregated history bucket across all series.
+struct AggregateEntry {
+    int64_t bucket_start_ms;
+    MetricAggregate series[METRIC_SERIES_COUNT];
+};
+
+// One downsampled retention tier: incoming raw samples fold into the
+// current bucket in O(1), and a finished bucket is published into a
+// seqlock ring of AggregateEntry when the first sample of the next
+// bucket arrives. Same single-producer contract as the raw ring.
+class RollupTier {
+public:
+    RollupTier(std::chrono::milliseconds bucket_width, size_t capacity)
+        : bucket_width_ms_(bucket_width.count()), ring_(capacity) {}
+
+    // Producer side. Must only be called from one thread.
+    void add_sample(const HistoryEntry& entry) {
+        int64_t bucket_start =
+            entry.timestamp_ms - entry.timestamp_ms % bucket_width_ms_;
+
+        if (open_bucket_.bucket_start_ms != bucket_start) {
+            flush_open_bucket();
+            open_bucket_.bucket_start_ms = bucket_start;
+        }
+
+        const double values[METRIC_SERIES_COUNT] = {
+            entry.cpu_usage, entry.memory_usage, entry.disk_usage,
+            entry.network_rx, entry.network_tx,
+        };
+        for (size_t i = 0; i < METRIC_SERIES_COUNT; ++i) {
+            MetricAggregate& agg = open_bucket_.series[i];
+            if (agg.count == 0) {
+                agg.min = agg.max = values[i];
+            } else {
+                if (values[i] < agg.min) agg.min = values[i];
+                if (values[i] > agg.max) agg.max = values[i];
+            }
+            agg.sum += values[i];
+            ++agg.count;
+        }
+    }
+
+    std::vector<AggregateEntry> read(size_t count = 0) const {
+        return ring_.read(count);
+    }
+
+    size_t size() const { return ring_.size(); }
+
+private:
+    void flush_open_bucket() {
+        if (open_bucket_.series[0].count > 0) {
+            ring_.push(open_bucket_);
+        }
+        open_bucket_ = AggregateEntry{};
+    }
+
+    int64_t bucket_width_ms_;
+    AggregateEntry open_bucket_{};
+    MetricRing<AggregateEntry> ring_;
+};
+
+#endif // PERFORMANCE_MONITOR_H
@@ -0,0 +1,117 @@
+#ifndef PROC_STAT_PARSER_H
+#define PROC_STAT_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Pure buffer parsers for the /proc formats the collectors read. Kept
+// free of platform calls so they can be exercised against synthetic
+// fixtures by the benchmark harness.
+
+// Advances `p` past one unsigned integer field and a trailing space.
+inline unsigned long long parse_ull_field(const char*& p) {
+    unsigned long long value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<unsigned long long>(*p - '0');
+        ++p;
+    }
+    if (*p == ' ') ++p;
+    return value;
+}
+
+// Skips `n` whitespace-separated fields.
+inline void skip_fields(const char*& p, int n) {
+    for (int i = 0; i < n; ++i) {
+        while (*p != ' ' && *p != '\0') ++p;
+        if (*p == ' ') ++p;
+    }
+}
+
+// Cumulative tick counts for one cpu line of /proc/stat.
+struct CpuTicks {
+    unsigned long long total = 0;
+    unsigned long long idle = 0;
+};
+
+// Parses the aggregate "cpu" line and every "cpuN" line out of a
+// /proc/stat buffer in one pass. `cores` is resized as needed and
+// indexed by core number. Returns the number of cpu lines consumed.
+inline size_t parse_proc_stat_cpus(const char* buffer, CpuTicks& aggregate,
+                                   std::vector<CpuTicks>& cores) {
+    size_t lines = 0;
+    const char* p = buffer;
+    while (*p) {
+        if (strncmp(p, "cpu", 3) != 0) break; // cpu lines come first
+
+        p += 3;
+        bool is_aggregate = (*p == ' ');
+        size_t core = 0;
+        while (*p >= '0' && *p <= '9') {
+            core = core * 10 + static_cast<size_t>(*p - '0');
+            ++p;
+        }
+        while (*p == ' ') ++p;
+
+        // user nice system idle iowait irq softirq steal [guest...]
+        CpuTicks ticks;
+        for (int field = 0; field < 8 && *p && *p != '\n'; ++field) {
+            unsigned long long value = parse_ull_field(p);
+            ticks.total += value;
+            if (field == 3 || field == 4) ticks.idle += value; // idle+iowait
+        }
+
+        if (is_aggregate) {
+            aggregate = ticks;
+        } else {
+            if (core >= cores.size()) {
+                cores.resize(core + 1);
+            }
+            cores[core] = ticks;
+        }
+        ++lines;
+
+        while (*p && *p != '\n') ++p;
+        if (*p == '\n') ++p;
+    }
+    return lines;
+}
+
+// The fields the process scanner needs from one /proc/[pid]/stat
+// buffer. name_begin/name_end point into the parsed buffer.
+struct PidStatRecord {
+    uint32_t pid = 0;
+    const char* name_begin = nullptr;
+    const char* name_end = nullptr;
+    char state = '?';
+    unsigned long long utime = 0;
+    unsigned long long stime = 0;
+    unsigned long long rss_pages = 0;
+};
+
+// Parses one /proc/[pid]/stat buffer. The comm field may contain
+// spaces and parens, so parsing is anchored on the last ')'.
+inline bool parse_pid_stat(const char* buffer, PidStatRecord& out) {
+    const char* p = buffer;
+    out.pid = static_cast<uint32_t>(parse_ull_field(p));
+
+    const char* comm_start = strchr(p, '(');
+    const char* comm_end = strrchr(p, ')');
+    if (!comm_start || !comm_end || comm_end < comm_start) return false;
+    out.name_begin = comm_start + 1;
+    out.name_end = comm_end;
+
+    p = comm_end + 2; // skip ") "
+    out.state = *p;
+    skip_fields(p, 1);  // state
+    skip_fields(p, 10); // ppid..cmajflt (fields 4-13)
+    out.utime = parse_ull_field(p);
+    out.stime = parse_ull_field(p);
+    skip_fields(p, 7);  // cutime..starttime (fields 16-22)
+    skip_fields(p, 1);  // vsize (field 23)
+    out.rss_pages = parse_ull_field(p);
+    return true;
+}
+
+#endif // PROC_STAT_PARSER_H
@@ -0,0 +1,165 @@
+#ifndef SELF_STATS_H
+#define SELF_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "json_writer.h"
+
+// Internal instrumentation so the monitor can measure itself.
+//
+// Each probe site owns a fixed-bucket power-of-two latency histogram;
+// recording is one relaxed atomic increment per bucket plus a running
+// sum, a few nanoseconds and no locks, so probing the collectors does
+// not distort what they measure. Percentiles are estimated from bucket
+// upper bounds at read time, HDR-style.
+class LatencyHistogram {
+public:
+    static const size_t BUCKET_COUNT = 40; // 2^0 .. 2^39 ns (~9 minutes)
+
+    void record(uint64_t nanos) {
+        size_t bucket = 0;
+        uint64_t bound = 1;
+        while (bucket + 1 < BUCKET_COUNT && nanos >= bound) {
+            bound <<= 1;
+            ++bucket;
+        }
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(nanos, std::memory_order_relaxed);
+
+        uint64_t seen_max = max_ns_.load(std::memory_order_relaxed);
+        while (nanos > seen_max &&
+               !max_ns_.compare_exchange_weak(seen_max, nanos,
+                                              std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+
+    // Upper-bound estimate of the given percentile in nanoseconds.
+    uint64_t percentile_ns(double fraction) const {
+        uint64_t total = count();
+        if (total == 0) return 0;
+
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total));
+        if (rank >= total) rank = total - 1;
+
+        uint64_t cumulative = 0;
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+            cumulative += buckets_[bucket].load(std::memory_order_relaxed);
+            if (cumulative > rank) {
+                return 1ull << bucket; // bucket upper bound
+            }
+        }
+        return max_ns();
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+// Fixed probe sites; adding one means adding an enum entry and a name.
+enum class ProbeId {
+    CollectCpuMemory = 0,
+    CollectDisk,
+    CollectNetwork,
+    CollectProcesses,
+    HistoryFlush,
+    HandleRequest,
+    PROBE_COUNT,
+};
+
+class SelfStats {
+public:
+    static SelfStats& instance() {
+        static SelfStats stats;
+        return stats;
+    }
+
+    LatencyHistogram& site(ProbeId id) {
+        return histograms_[static_cast<size_t>(id)];
+    }
+
+    static const char* site_name(ProbeId id) {
+        static const char* names[] = {
+            "collect_cpu_memory", "collect_disk", "collect_network",
+            "collect_processes", "history_flush", "handle_request",
+        };
+        return names[static_cast<size_t>(id)];
+    }
+
+    // JSON for the /debug/self endpoint.
+    std::string render() {
+        std::string out;
+        out.reserve(1024);
+        JsonWriter json(out);
+
+        json.literal("{\n  \"probes\": [\n");
+        for (size_t i = 0; i < static_cast<size_t>(ProbeId::PROBE_COUNT); ++i) {
+            LatencyHistogram& histogram = histograms_[i];
+            uint64_t count = histogram.count();
+
+            json.literal("    {\n      \"site\": ");
+            json.append_escaped(site_name(static_cast<ProbeId>(i)));
+            json.literal(",\n      \"count\": ");
+            json.append_uint(count);
+            json.literal(",\n      \"avg_us\": ");
+            json.append_fixed(count > 0
+                                  ? static_cast<double>(histogram.sum_ns()) /
+                                        static_cast<double>(count) / 1000.0
+                                  : 0.0);
+            json.literal(",\n      \"p50_us\": ");
+            json.append_fixed(static_cast<double>(histogram.percentile_ns(0.50)) / 1000.0);
+            json.literal(",\n      \"p90_us\": ");
+            json.append_fixed(static_cast<double>(histogram.percentile_ns(0.90)) / 1000.0);
+            json.literal(",\n      \"p99_us\": ");
+            json.append_fixed(static_cast<double>(histogram.percentile_ns(0.99)) / 1000.0);
+            json.literal(",\n      \"max_us\": ");
+            json.append_fixed(static_cast<double>(histogram.max_ns()) / 1000.0);
+            json.literal("\n    }");
+            if (i + 1 < static_cast<size_t>(ProbeId::PROBE_COUNT)) json.literal(",");
+            json.literal("\n");
+        }
+        json.literal("  ]\n}");
+        return out;
+    }
+
+    SelfStats(const SelfStats&) = delete;
+    SelfStats& operator=(const SelfStats&) = delete;
+
+private:
+    SelfStats() = default;
+
+    LatencyHistogram histograms_[static_cast<size_t>(ProbeId::PROBE_COUNT)];
+};
+
+// RAII probe: times its scope and records into the site's histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(ProbeId id)
+        : id_(id), start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        SelfStats::instance().site(id_).record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    ProbeId id_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif // SELF_STATS_H
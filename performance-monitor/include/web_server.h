@@ -0,0 +1,9 @@
+#ifndef WEB_SERVER_H
+#define WEB_SERVER_H
+
+// Shared web server settings. The server implementation itself lives in
+// main.cpp alongside the metrics collector it serves.
+
+const int DEFAULT_SERVER_PORT = 9000;
+
+#endif // WEB_SERVER_H
@@ -8,9 +8,12 @@
 #include <sstream>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
-#include <queue>
 #include <algorithm>
+#include <functional>
+#include <queue>
+#include <deque>
 #include <iomanip>
 
 #ifdef _WIN32
@@ -22,51 +25,131 @@
     #include <sys/sysinfo.h>
     #include <sys/types.h>
     #include <sys/stat.h>
+    #include <sys/statvfs.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/uio.h>
+    #include <sys/signalfd.h>
+    #include <signal.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <netdb.h>
+    #include <fcntl.h>
     #include <unistd.h>
     #include <dirent.h>
+    #include <linux/netlink.h>
+    #include <linux/connector.h>
+    #include <linux/cn_proc.h>
+    #include <cerrno>
+    #include <climits>
+    #include <cstdio>
+    #include <cstdlib>
+    #include <cstring>
+    #include <unordered_map>
+    #include <unordered_set>
 #endif
 
+#include "adaptive_governor.h"
+#include "alert_engine.h"
+#include "fleet_aggregator.h"
 #include "performance_monitor.h"
+#include "history_file.h"
+#include "json_writer.h"
+#include "metric_registry.h"
+#include "metrics_format.h"
+#include "proc_stat_parser.h"
+#include "self_stats.h"
 #include "web_server.h"
+#include "wire_format.h"
 #include "logger.h"
 
 class SystemMetrics {
 private:
     std::atomic<bool> monitoring{false};
     std::thread monitoring_thread;
-    std::mutex data_mutex;
-    std::queue<MetricSnapshot> metric_history;
-    static const size_t MAX_HISTORY_SIZE = 1000;
-    
+    std::mutex stop_mutex;
+    std::condition_variable stop_condition;
+    // The process table scan is the one collector slow enough to delay
+    // the cheap scalar ticks, so it runs on a persistent worker thread;
+    // the scheduler only signals it and never waits for it.
+    std::thread process_worker;
+    std::mutex process_worker_mutex;
+    std::condition_variable process_worker_condition;
+    bool process_scan_requested = false;
+    SamplingConfig sampling_config;
+    // Tiered retention: raw samples for the last hour, 1-minute rollups
+    // for a day, 1-hour rollups for 90 days beyond that.
+    static const size_t MAX_HISTORY_SIZE = 3600;
+    static const size_t MINUTE_TIER_CAPACITY = 1440;
+    static const size_t HOUR_TIER_CAPACITY = 2160;
+    MetricHistoryRing metric_history{MAX_HISTORY_SIZE};
+    MetricSeriesStore metric_series{MAX_HISTORY_SIZE};
+    RollupTier minute_tier{std::chrono::minutes(1), MINUTE_TIER_CAPACITY};
+    RollupTier hour_tier{std::chrono::hours(1), HOUR_TIER_CAPACITY};
+
+    // Bumped once per completed sampling tick; consumers use it to tell
+    // whether cached derived data (rendered JSON, etc.) is still fresh.
+    std::atomic<uint64_t> data_generation{0};
+
+    std::mutex latest_mutex;
+    MetricSnapshot latest_snapshot;
+
+    HistoryFile history_file{"performance_history.bin"};
+
+    AlertEngine alert_engine;
+
+    // Degrades the expensive collectors when our own CPU share exceeds
+    // its budget. Written by the scheduler, read by the process worker.
+    AdaptiveGovernor governor;
+    int64_t governor_prev_cpu_us = -1;
+    std::chrono::steady_clock::time_point governor_prev_wall;
+
     Logger logger;
-    
+
 public:
-    SystemMetrics() : logger("PerformanceMonitor") {}
-    
-    struct MetricSnapshot {
-        std::chrono::steady_clock::time_point timestamp;
-        double cpu_usage;
-        double memory_usage;
-        double disk_usage;
-        double network_rx;
-        double network_tx;
-        std::vector<ProcessInfo> top_processes;
-    };
-    
-    struct ProcessInfo {
-        uint32_t pid;
-        std::string name;
-        double cpu_percent;
-        uint64_t memory_bytes;
-        std::string status;
-    };
-    
+    explicit SystemMetrics(const SamplingConfig& config = SamplingConfig(),
+                           const std::vector<AlertRule>& alert_rules =
+                               default_alert_rules())
+        : sampling_config(config), governor(config.self_cpu_budget_percent),
+          logger("PerformanceMonitor") {
+        for (const auto& rule : alert_rules) {
+            alert_engine.add_rule(rule);
+        }
+    }
+
     void start_monitoring() {
         if (monitoring.load()) {
             return;
         }
         
+        if (history_file.open_or_create()) {
+            // Warm the in-memory history from the previous run's tail.
+            std::vector<HistoryEntry> persisted;
+            history_file.load_tail(MAX_HISTORY_SIZE, persisted);
+            for (const auto& entry : persisted) {
+                metric_history.push(entry);
+                metric_series.push_row(entry);
+                minute_tier.add_sample(entry);
+                hour_tier.add_sample(entry);
+            }
+            if (!persisted.empty()) {
+                logger.info("Recovered " + std::to_string(persisted.size()) +
+                            " history entries from disk");
+            }
+        } else {
+            logger.warn("History persistence disabled (could not open history file)");
+        }
+
+#ifndef _WIN32
+        load_collector_state();
+#endif
+        prewarm_memory();
+        prime_collectors();
+
         monitoring.store(true);
+        process_worker = std::thread(&SystemMetrics::process_scan_loop, this);
         monitoring_thread = std::thread(&SystemMetrics::monitor_loop, this);
         logger.info("Performance monitoring started");
     }
@@ -76,46 +159,65 @@ public:
             return;
         }
         
-        monitoring.store(false);
+        // The store and notify happen under the same mutex each waiter's
+        // predicate runs under, or a notify landing between a waiter's
+        // predicate check and its re-sleep is lost and join() hangs.
+        {
+            std::lock_guard<std::mutex> lock(stop_mutex);
+            monitoring.store(false);
+            stop_condition.notify_all();
+        }
+        {
+            std::lock_guard<std::mutex> lock(process_worker_mutex);
+            process_worker_condition.notify_all();
+        }
         if (monitoring_thread.joinable()) {
             monitoring_thread.join();
         }
+        if (process_worker.joinable()) {
+            process_worker.join();
+        }
+#ifndef _WIN32
+        if (proc_events_fd >= 0) {
+            close(proc_events_fd);
+            proc_events_fd = -1;
+        }
+        save_collector_state();
+#endif
+        // MS_SYNC flush of everything appended this run.
+        history_file.close_file();
         logger.info("Performance monitoring stopped");
     }
     
-    MetricSnapshot get_current_metrics() {
-        MetricSnapshot snapshot;
-        snapshot.timestamp = std::chrono::steady_clock::now();
-        
-        try {
-            snapshot.cpu_usage = get_cpu_usage();
-            snapshot.memory_usage = get_memory_usage();
-            snapshot.disk_usage = get_disk_usage();
-            auto network = get_network_usage();
-            snapshot.network_rx = network.first;
-            snapshot.network_tx = network.second;
-            snapshot.top_processes = get_top_processes(10);
-        } catch (const std::exception& e) {
-            logger.error("Error collecting metrics: " + std::string(e.what()));
-        }
-        
-        return snapshot;
+    std::vector<HistoryEntry> get_history(size_t count = 0) {
+        return metric_history.read(count);
     }
-    
-    std::vector<MetricSnapshot> get_history(size_t count = 0) {
-        std::lock_guard<std::mutex> lock(data_mutex);
-        std::vector<MetricSnapshot> history;
-        
-        size_t size = metric_history.size();
-        size_t items = (count == 0 || count > size) ? size : count;
-        
-        std::queue<MetricSnapshot> temp = metric_history;
-        for (size_t i = 0; i < items && !temp.empty(); ++i) {
-            history.push_back(temp.front());
-            temp.pop();
-        }
-        
-        return history;
+
+    // Pre-aggregated tiers; a day-long chart reads ~1440 records
+    // instead of recomputing over raw samples.
+    std::vector<AggregateEntry> get_rollup_history(HistoryResolution resolution,
+                                                   size_t count = 0) {
+        return resolution == HistoryResolution::Hour ? hour_tier.read(count)
+                                                     : minute_tier.read(count);
+    }
+
+    // Last snapshot taken by the monitor loop. Serving this instead of
+    // re-collecting keeps request handling off the /proc scan path.
+    MetricSnapshot get_latest_metrics() {
+        std::lock_guard<std::mutex> lock(latest_mutex);
+        return latest_snapshot;
+    }
+
+    uint64_t generation() const {
+        return data_generation.load(std::memory_order_acquire);
+    }
+
+    std::vector<double> get_series(MetricId id, size_t count = 0) {
+        return metric_series.get_series(id, count);
+    }
+
+    std::vector<int64_t> get_series_timestamps(size_t count = 0) {
+        return metric_series.get_timestamps(count);
     }
     
     std::string get_system_info() {
@@ -151,34 +253,320 @@ public:
     }
     
 private:
+    // Staging area for the most recent value from each collector.
+    // Only the monitor thread touches these.
+    double staged_cpu = 0.0;
+    double staged_memory = 0.0;
+    double staged_disk = 0.0;
+    double staged_network_rx = 0.0;
+    double staged_network_tx = 0.0;
+    double staged_cgroup_cpu = -1.0;
+    std::vector<double> staged_per_core_cpu;
+    std::vector<InterfaceRate> staged_interface_rates;
+
+    // Hand-off from the process worker; unlike the staging area above
+    // this is written off the monitor thread, hence the mutex.
+    std::mutex process_result_mutex;
+    std::shared_ptr<const ProcessTable> process_result;
+
+    // Worker-owned freelist of process tables. A table whose use count
+    // is back to 1 is no longer referenced by any snapshot and can be
+    // recycled; at steady state the pool settles at two or three tables
+    // and scans stop allocating entirely.
+    std::vector<std::shared_ptr<ProcessTable>> process_table_pool;
+
+    std::shared_ptr<ProcessTable> acquire_process_table() {
+        for (auto& table : process_table_pool) {
+            if (table.use_count() == 1) {
+                table->clear();
+                return table;
+            }
+        }
+        process_table_pool.push_back(std::make_shared<ProcessTable>());
+        return process_table_pool.back();
+    }
+
+    // Touches every page of the history ring and column store on the
+    // startup thread, before any collector or serving thread exists:
+    // placement is then a deterministic single-node first-touch instead
+    // of whichever thread happens to fault a page in first, and no
+    // request ever pays the fault. The ranges also get hugepage advice
+    // — a no-op at today's capacities, but it keeps TLB pressure flat
+    // if MAX_HISTORY_SIZE grows past a couple of megabytes.
+    void prewarm_memory() {
+#ifndef _WIN32
+        advise_and_touch(metric_history.storage(), metric_history.storage_bytes());
+        metric_series.for_each_storage([](void* base, size_t bytes) {
+            advise_and_touch(base, bytes);
+        });
+#endif
+    }
+
+#ifndef _WIN32
+    static void advise_and_touch(void* base, size_t bytes) {
+        if (!base || bytes == 0) return;
+
+        // Hugepage advice wants page-aligned bounds; round inward.
+        const uintptr_t page = 4096;
+        uintptr_t start = reinterpret_cast<uintptr_t>(base);
+        uintptr_t aligned = (start + page - 1) & ~(page - 1);
+        uintptr_t end = start + bytes;
+        if (aligned + page <= end) {
+            madvise(reinterpret_cast<void*>(aligned),
+                    (end - aligned) & ~(page - 1), MADV_HUGEPAGE);
+        }
+
+        volatile char* touch = static_cast<volatile char*>(base);
+        for (size_t offset = 0; offset < bytes; offset += page) {
+            touch[offset] = touch[offset];
+        }
+        touch[bytes - 1] = touch[bytes - 1];
+    }
+#endif
+
+    // Delta-based collectors return 0.0 until they have a baseline, so
+    // without this the first published samples lie for up to a full
+    // interval. Take the baselines now, let the counters move for a
+    // beat, and stage a real reading before the scheduler starts.
+    void prime_collectors() {
+        get_cpu_usage();
+        get_network_usage();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        staged_cpu = get_cpu_usage();
+        auto network = get_network_usage();
+        staged_network_rx = network.first;
+        staged_network_tx = network.second;
+        staged_memory = get_memory_usage();
+        staged_disk = get_disk_usage();
+    }
+
+    enum class CollectorId { CpuMemory, Disk, Network, Processes, History, Governor };
+
+    // How often the governor re-measures our own CPU share.
+    static const int64_t GOVERNOR_WINDOW_MS = 5000;
+
+    struct ScheduledCollector {
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::milliseconds interval;
+        CollectorId id;
+
+        bool operator>(const ScheduledCollector& other) const {
+            return deadline > other.deadline;
+        }
+    };
+
+    // Min-heap of next-due collectors driven by absolute deadlines, so
+    // each collector keeps its own cadence and the cadence doesn't
+    // drift with collection cost.
     void monitor_loop() {
+        using clock = std::chrono::steady_clock;
+
+        std::priority_queue<ScheduledCollector, std::vector<ScheduledCollector>,
+                            std::greater<ScheduledCollector>> schedule;
+        auto now = clock::now();
+        // The primed collectors already staged a real reading; running
+        // them again immediately would take a zero-length delta and
+        // clobber it with 0.0, so their first slot is one interval out.
+        // History flushes right away to publish the primed values.
+        schedule.push({now + sampling_config.cpu_memory_interval,
+                       sampling_config.cpu_memory_interval, CollectorId::CpuMemory});
+        schedule.push({now + sampling_config.disk_interval,
+                       sampling_config.disk_interval, CollectorId::Disk});
+        schedule.push({now + sampling_config.network_interval,
+                       sampling_config.network_interval, CollectorId::Network});
+        schedule.push({now, sampling_config.process_interval, CollectorId::Processes});
+        schedule.push({now, sampling_config.history_interval, CollectorId::History});
+        schedule.push({now, std::chrono::milliseconds(GOVERNOR_WINDOW_MS),
+                       CollectorId::Governor});
+
         while (monitoring.load()) {
+            ScheduledCollector next = schedule.top();
+            schedule.pop();
+
+            {
+                std::unique_lock<std::mutex> lock(stop_mutex);
+                stop_condition.wait_until(lock, next.deadline,
+                                          [this] { return !monitoring.load(); });
+            }
+            if (!monitoring.load()) break;
+
             try {
-                MetricSnapshot snapshot = get_current_metrics();
-                
-                std::lock_guard<std::mutex> lock(data_mutex);
-                metric_history.push(snapshot);
-                
-                if (metric_history.size() > MAX_HISTORY_SIZE) {
-                    metric_history.pop();
-                }
-                
-                // Log critical metrics
-                if (snapshot.cpu_usage > 90.0) {
-                    logger.warn("High CPU usage: " + std::to_string(snapshot.cpu_usage) + "%");
-                }
-                if (snapshot.memory_usage > 90.0) {
-                    logger.warn("High memory usage: " + std::to_string(snapshot.memory_usage) + "%");
-                }
-                
+                run_collector(next.id);
             } catch (const std::exception& e) {
                 logger.error("Monitor loop error: " + std::string(e.what()));
             }
-            
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+
+            // If a collector overran its own slot, skip the missed runs
+            // instead of bursting to catch up. Process scans also honor
+            // the governor's stretch factor while shedding.
+            std::chrono::milliseconds interval = next.interval;
+            if (next.id == CollectorId::Processes) {
+                interval *= governor.process_scan_multiplier();
+            }
+            next.deadline += interval;
+            auto after = clock::now();
+            while (next.deadline < after) {
+                next.deadline += interval;
+            }
+            schedule.push(next);
         }
     }
-    
+
+    void run_collector(CollectorId id) {
+        switch (id) {
+            case CollectorId::CpuMemory: {
+                ScopedTimer probe(ProbeId::CollectCpuMemory);
+                staged_cpu = get_cpu_usage();
+                staged_memory = get_memory_usage();
+                break;
+            }
+            case CollectorId::Disk: {
+                ScopedTimer probe(ProbeId::CollectDisk);
+                staged_disk = get_disk_usage();
+                break;
+            }
+            case CollectorId::Network: {
+                ScopedTimer probe(ProbeId::CollectNetwork);
+                auto network = get_network_usage();
+                staged_network_rx = network.first;
+                staged_network_tx = network.second;
+                break;
+            }
+            case CollectorId::Processes: {
+                std::lock_guard<std::mutex> lock(process_worker_mutex);
+                process_scan_requested = true;
+                process_worker_condition.notify_one();
+                break;
+            }
+            case CollectorId::History: {
+                ScopedTimer probe(ProbeId::HistoryFlush);
+                flush_history_tick();
+                break;
+            }
+            case CollectorId::Governor: {
+                update_governor();
+                break;
+            }
+        }
+    }
+
+    // Measures our own CPU share over the last window and lets the
+    // governor move the shedding level; transitions are logged once.
+    void update_governor() {
+#ifndef _WIN32
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        int64_t cpu_us =
+            (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ll +
+            usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+        auto now = std::chrono::steady_clock::now();
+
+        if (governor_prev_cpu_us >= 0) {
+            int64_t wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                now - governor_prev_wall).count();
+            if (wall_us > 0) {
+                double share =
+                    100.0 * static_cast<double>(cpu_us - governor_prev_cpu_us) /
+                    static_cast<double>(wall_us);
+                int before = governor.level();
+                int after = governor.update(share);
+                if (after > before) {
+                    logger.warn("Self CPU " + std::to_string(share) +
+                                "% over budget; shedding collection detail (level " +
+                                std::to_string(after) + ")");
+                } else if (after < before) {
+                    logger.info("Self CPU back under budget; restoring collection detail (level " +
+                                std::to_string(after) + ")");
+                }
+            }
+        }
+        governor_prev_cpu_us = cpu_us;
+        governor_prev_wall = now;
+#endif
+    }
+
+    // Runs the process table scan off the scheduler thread so a slow
+    // /proc pass can't delay the cheap scalar ticks; per-tick wall time
+    // becomes max(collector) instead of sum(collector). The scan's
+    // delta state (prev_proc_ticks etc.) is only ever touched here.
+    void process_scan_loop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(process_worker_mutex);
+                process_worker_condition.wait(lock, [this]() {
+                    return process_scan_requested || !monitoring.load();
+                });
+                if (!monitoring.load()) {
+                    return;
+                }
+                process_scan_requested = false;
+            }
+
+            std::shared_ptr<ProcessTable> table = acquire_process_table();
+            {
+                ScopedTimer probe(ProbeId::CollectProcesses);
+                scan_top_processes(*table, governor.top_process_count(10),
+                                   governor.enrich_processes());
+            }
+            {
+                std::lock_guard<std::mutex> lock(process_result_mutex);
+                process_result = table;
+            }
+        }
+    }
+
+    // Assembles the staged values into one snapshot, publishes it and
+    // appends to the history stores. Runs at history_interval.
+    void flush_history_tick() {
+        MetricSnapshot snapshot;
+        snapshot.timestamp = std::chrono::steady_clock::now();
+        snapshot.cpu_usage = staged_cpu;
+        snapshot.memory_usage = staged_memory;
+        snapshot.disk_usage = staged_disk;
+        snapshot.network_rx = staged_network_rx;
+        snapshot.network_tx = staged_network_tx;
+        snapshot.cgroup_cpu_usage = staged_cgroup_cpu;
+        snapshot.per_core_cpu = staged_per_core_cpu;
+        snapshot.interface_rates = staged_interface_rates;
+        {
+            std::lock_guard<std::mutex> lock(process_result_mutex);
+            snapshot.top_processes = process_result;
+        }
+
+        HistoryEntry entry;
+        entry.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                snapshot.timestamp.time_since_epoch()).count();
+        entry.cpu_usage = snapshot.cpu_usage;
+        entry.memory_usage = snapshot.memory_usage;
+        entry.disk_usage = snapshot.disk_usage;
+        entry.network_rx = snapshot.network_rx;
+        entry.network_tx = snapshot.network_tx;
+        metric_history.push(entry);
+        metric_series.push_row(entry);
+        minute_tier.add_sample(entry);
+        hour_tier.add_sample(entry);
+        history_file.append(entry);
+
+        // Alert rules fire/resolve on transitions only, not once per
+        // sample while a condition holds.
+        alert_engine.evaluate(entry, [this](const AlertRule& rule, bool firing,
+                                            double value) {
+            if (firing) {
+                logger.warn("ALERT firing: " + rule.name +
+                            " (value " + std::to_string(value) + ")");
+            } else {
+                logger.info("ALERT resolved: " + rule.name);
+            }
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(latest_mutex);
+            latest_snapshot = std::move(snapshot);
+        }
+        data_generation.fetch_add(1, std::memory_order_release);
+    }
+
+
 #ifdef _WIN32
     double get_cpu_usage() {
         static PDH_HQUERY cpuQuery;
@@ -226,92 +614,222 @@ private:
         return {0.0, 0.0};
     }
     
-    std::vector<ProcessInfo> get_top_processes(size_t count) {
-        std::vector<ProcessInfo> processes;
-        
+    void scan_top_processes(ProcessTable& table, size_t count, bool enrich) {
+        (void)enrich;  // no per-pid enrichment on Windows
         HANDLE hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
         if (hProcessSnap == INVALID_HANDLE_VALUE) {
-            return processes;
+            return;
         }
-        
+
         PROCESSENTRY32 pe32;
         pe32.dwSize = sizeof(PROCESSENTRY32);
-        
+
         if (Process32First(hProcessSnap, &pe32)) {
             do {
-                ProcessInfo info;
-                info.pid = pe32.th32ProcessID;
-                
                 // Convert wide string to string
                 std::wstring wname(pe32.szExeFile);
-                info.name = std::string(wname.begin(), wname.end());
-                
+                std::string name(wname.begin(), wname.end());
+
+                uint64_t memory_bytes = 0;
                 HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pe32.th32ProcessID);
                 if (hProcess) {
                     PROCESS_MEMORY_COUNTERS pmc;
                     if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc))) {
-                        info.memory_bytes = pmc.WorkingSetSize;
+                        memory_bytes = pmc.WorkingSetSize;
                     }
                     CloseHandle(hProcess);
                 }
-                
-                info.cpu_percent = 0.0; // Would need more complex calculation
-                info.status = "running";
-                
-                processes.push_back(info);
-                
-            } while (Process32Next(hProcessSnap, &pe32) && processes.size() < count);
+
+                // CPU percent would need more complex calculation
+                table.add(pe32.th32ProcessID, name.data(), name.size(),
+                          0.0, memory_bytes, ProcessState::Running);
+
+            } while (Process32Next(hProcessSnap, &pe32) && table.size() < count);
         }
-        
+
         CloseHandle(hProcessSnap);
-        
+
         // Sort by memory usage
-        std::sort(processes.begin(), processes.end(), 
-                  [](const ProcessInfo& a, const ProcessInfo& b) {
+        std::sort(table.records().begin(), table.records().end(),
+                  [](const ProcessRecord& a, const ProcessRecord& b) {
                       return a.memory_bytes > b.memory_bytes;
                   });
-        
-        return processes;
     }
     
 #else
+    // CPU collector state (monitor thread only). Per-core deltas live
+    // in flat arrays indexed by core number; the aggregate line is
+    // tracked separately.
+    CpuTicks prev_cpu_total;
+    std::vector<CpuTicks> prev_core_ticks;
+    std::vector<CpuTicks> curr_core_ticks;
+    bool cpu_first_sample = true;
+    char stat_read_buffer[65536]; // comfortably fits several hundred cores
+
+    // cgroup-v2 CPU accounting, when this host/container has it.
+    unsigned long long cgroup_prev_usage_usec = 0;
+    std::chrono::steady_clock::time_point cgroup_prev_time{};
+
+    static double ticks_to_percent(const CpuTicks& now, const CpuTicks& prev) {
+        unsigned long long delta_total = now.total - prev.total;
+        unsigned long long delta_idle = now.idle - prev.idle;
+        if (delta_total == 0) return 0.0;
+        return static_cast<double>(delta_total - delta_idle) /
+               static_cast<double>(delta_total) * 100.0;
+    }
+
+    // One read and one pass over /proc/stat covers the aggregate line
+    // and every cpuN line; same syscall count as the old
+    // aggregate-only collector.
     double get_cpu_usage() {
-        static unsigned long long lastTotalUser, lastTotalUserLow, lastTotalSys, lastTotalIdle;
-        static bool first_call = true;
-        
-        std::ifstream file("/proc/stat");
-        std::string line;
-        std::getline(file, line);
-        
-        std::istringstream iss(line);
-        std::string cpu;
-        unsigned long long totalUser, totalUserLow, totalSys, totalIdle, total;
-        
-        iss >> cpu >> totalUser >> totalUserLow >> totalSys >> totalIdle;
-        
-        if (first_call) {
-            lastTotalUser = totalUser;
-            lastTotalUserLow = totalUserLow;
-            lastTotalSys = totalSys;
-            lastTotalIdle = totalIdle;
-            first_call = false;
-            return 0.0;
+        int fd = open("/proc/stat", O_RDONLY);
+        if (fd < 0) return 0.0;
+        ssize_t n = pread(fd, stat_read_buffer, sizeof(stat_read_buffer) - 1, 0);
+        close(fd);
+        if (n <= 0) return 0.0;
+        stat_read_buffer[n] = '\0';
+
+        CpuTicks aggregate_ticks;
+        parse_proc_stat_cpus(stat_read_buffer, aggregate_ticks, curr_core_ticks);
+
+        double aggregate = 0.0;
+        if (!cpu_first_sample) {
+            aggregate = ticks_to_percent(aggregate_ticks, prev_cpu_total);
         }
-        
-        total = (totalUser - lastTotalUser) + (totalUserLow - lastTotalUserLow) + (totalSys - lastTotalSys);
-        double percent = total;
-        total += (totalIdle - lastTotalIdle);
-        percent /= total;
-        percent *= 100;
-        
-        lastTotalUser = totalUser;
-        lastTotalUserLow = totalUserLow;
-        lastTotalSys = totalSys;
-        lastTotalIdle = totalIdle;
-        
+        prev_cpu_total = aggregate_ticks;
+
+        if (curr_core_ticks.size() > prev_core_ticks.size()) {
+            prev_core_ticks.resize(curr_core_ticks.size());
+            staged_per_core_cpu.resize(curr_core_ticks.size(), 0.0);
+        }
+        for (size_t core = 0; core < curr_core_ticks.size(); ++core) {
+            staged_per_core_cpu[core] =
+                cpu_first_sample ? 0.0
+                                 : ticks_to_percent(curr_core_ticks[core],
+                                                    prev_core_ticks[core]);
+            prev_core_ticks[core] = curr_core_ticks[core];
+        }
+
+        cpu_first_sample = false;
+        staged_cgroup_cpu = get_cgroup_cpu_usage();
+        return aggregate;
+    }
+
+    // cgroup-v2 cpu.stat usage_usec delta over wall time; can exceed
+    // 100% on multi-core limits. Returns -1 when unavailable.
+    double get_cgroup_cpu_usage() {
+        int fd = open("/sys/fs/cgroup/cpu.stat", O_RDONLY);
+        if (fd < 0) return -1.0;
+
+        char buffer[512];
+        ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+        close(fd);
+        if (n <= 0) return -1.0;
+        buffer[n] = '\0';
+
+        const char* usage = strstr(buffer, "usage_usec ");
+        if (!usage) return -1.0;
+        usage += 11;
+        unsigned long long usage_usec = parse_ull_field(usage);
+
+        auto now = std::chrono::steady_clock::now();
+        double percent = -1.0;
+        if (cgroup_prev_time.time_since_epoch().count() != 0) {
+            double elapsed_usec =
+                std::chrono::duration<double, std::micro>(now - cgroup_prev_time).count();
+            if (elapsed_usec > 0 && usage_usec >= cgroup_prev_usage_usec) {
+                percent = static_cast<double>(usage_usec - cgroup_prev_usage_usec) /
+                          elapsed_usec * 100.0;
+            }
+        }
+        cgroup_prev_usage_usec = usage_usec;
+        cgroup_prev_time = now;
         return percent;
     }
-    
+
+    // CPU delta baselines persisted across restarts, so the first
+    // post-restart sample reports real utilization (the delta since
+    // shutdown) instead of 0.0 while a fresh baseline warms up. Only
+    // valid within the same boot and for quick redeploys: a different
+    // boot epoch or a stale file means the ticks are meaningless and
+    // the state is discarded.
+    static const int64_t COLLECTOR_STATE_MAX_AGE_MS = 15 * 60 * 1000;
+
+    struct CollectorStateHeader {
+        char magic[4];
+        uint32_t version;
+        int64_t saved_ms;      // wall clock at save
+        int64_t boot_epoch;    // seconds; identifies the boot
+        CpuTicks aggregate;
+        uint32_t core_count;
+    };
+
+    static int64_t boot_epoch_seconds() {
+        struct sysinfo si;
+        sysinfo(&si);
+        auto now = std::chrono::system_clock::now();
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   now.time_since_epoch()).count() - si.uptime;
+    }
+
+    void save_collector_state() {
+        if (cpu_first_sample) return; // no baseline learned yet
+
+        FILE* file = fopen("collector_state.bin", "wb");
+        if (!file) return;
+
+        CollectorStateHeader header{};
+        memcpy(header.magic, "PMCS", 4);
+        header.version = 1;
+        header.saved_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.boot_epoch = boot_epoch_seconds();
+        header.aggregate = prev_cpu_total;
+        header.core_count = static_cast<uint32_t>(prev_core_ticks.size());
+
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  (prev_core_ticks.empty() ||
+                   fwrite(prev_core_ticks.data(), sizeof(CpuTicks),
+                          prev_core_ticks.size(), file) == prev_core_ticks.size());
+        fclose(file);
+        if (!ok) {
+            unlink("collector_state.bin");
+        }
+    }
+
+    void load_collector_state() {
+        FILE* file = fopen("collector_state.bin", "rb");
+        if (!file) return;
+
+        CollectorStateHeader header{};
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                  memcmp(header.magic, "PMCS", 4) == 0 &&
+                  header.version == 1 && header.core_count < 4096;
+
+        int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        // Boot epoch can jitter by a second between sysinfo calls.
+        if (ok && (now_ms - header.saved_ms > COLLECTOR_STATE_MAX_AGE_MS ||
+                   std::abs(header.boot_epoch - boot_epoch_seconds()) > 2)) {
+            ok = false;
+        }
+
+        std::vector<CpuTicks> cores(header.core_count);
+        if (ok && header.core_count > 0) {
+            ok = fread(cores.data(), sizeof(CpuTicks), cores.size(), file) ==
+                 cores.size();
+        }
+        fclose(file);
+        if (!ok) return;
+
+        prev_cpu_total = header.aggregate;
+        prev_core_ticks = std::move(cores);
+        staged_per_core_cpu.assign(prev_core_ticks.size(), 0.0);
+        cpu_first_sample = false;
+        logger.info("Restored CPU baseline from previous run");
+    }
+
+
     double get_memory_usage() {
         struct sysinfo memInfo;
         sysinfo(&memInfo);
@@ -338,216 +856,1617 @@ private:
         return (double)used / (double)total * 100.0;
     }
     
+    // Network collector state (monitor thread only). Interface names
+    // are interned once; per-tick bookkeeping is index-based deltas in
+    // a flat array, no string allocation in the scan loop.
+    struct InterfaceCounters {
+        unsigned long long prev_rx = 0;
+        unsigned long long prev_tx = 0;
+        double rx_bps = 0.0;
+        double tx_bps = 0.0;
+        bool have_prev = false;
+    };
+    std::vector<std::string> interface_names;     // append-only, id == index
+    std::vector<InterfaceCounters> interface_counters;
+    std::chrono::steady_clock::time_point last_net_scan{};
+    char net_read_buffer[16384];
+
+    size_t intern_interface(const char* name, size_t length) {
+        for (size_t i = 0; i < interface_names.size(); ++i) {
+            if (interface_names[i].size() == length &&
+                memcmp(interface_names[i].data(), name, length) == 0) {
+                return i;
+            }
+        }
+        interface_names.emplace_back(name, length);
+        interface_counters.emplace_back();
+        return interface_names.size() - 1;
+    }
+
+    // Single-buffer scan of /proc/net/dev producing bytes/sec deltas
+    // per interface. Returns the summed non-loopback rates; per-
+    // interface rates land in staged_interface_rates.
     std::pair<double, double> get_network_usage() {
-        std::ifstream file("/proc/net/dev");
-        std::string line;
-        double rx_bytes = 0, tx_bytes = 0;
-        
-        // Skip header lines
-        std::getline(file, line);
-        std::getline(file, line);
-        
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string interface;
-            unsigned long long rx, tx;
-            
-            iss >> interface;
-            if (interface.find(':') != std::string::npos) {
-                interface = interface.substr(0, interface.find(':'));
-            }
-            
-            if (interface != "lo") { // Skip loopback
-                iss >> rx;
-                for (int i = 0; i < 7; ++i) iss >> rx; // Skip to tx
-                iss >> tx;
-                
-                rx_bytes += rx;
-                tx_bytes += tx;
+        int fd = open("/proc/net/dev", O_RDONLY);
+        if (fd < 0) return {0.0, 0.0};
+        ssize_t n = pread(fd, net_read_buffer, sizeof(net_read_buffer) - 1, 0);
+        close(fd);
+        if (n <= 0) return {0.0, 0.0};
+        net_read_buffer[n] = '\0';
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed_sec =
+            std::chrono::duration<double>(now - last_net_scan).count();
+        bool have_baseline =
+            last_net_scan.time_since_epoch().count() != 0 && elapsed_sec > 0.0;
+        last_net_scan = now;
+
+        double total_rx_bps = 0.0, total_tx_bps = 0.0;
+        staged_interface_rates.clear();
+
+        // Skip the two header lines.
+        const char* p = net_read_buffer;
+        for (int i = 0; i < 2 && p; ++i) {
+            p = strchr(p, '\n');
+            if (p) ++p;
+        }
+
+        while (p && *p) {
+            while (*p == ' ') ++p;
+            const char* name_start = p;
+            while (*p && *p != ':' && *p != '\n') ++p;
+            if (*p != ':') break;
+            size_t name_length = static_cast<size_t>(p - name_start);
+            ++p;
+            while (*p == ' ') ++p;
+
+            // rx: bytes packets errs drop fifo frame compressed multicast
+            // tx: bytes packets errs drop fifo colls carrier compressed
+            // Fields are right-aligned with variable-width space padding.
+            auto next_field = [&p]() {
+                while (*p == ' ') ++p;
+                return parse_ull_field(p);
+            };
+            unsigned long long rx_bytes = next_field();
+            for (int i = 0; i < 7; ++i) next_field();
+            unsigned long long tx_bytes = next_field();
+
+            size_t id = intern_interface(name_start, name_length);
+            InterfaceCounters& counters = interface_counters[id];
+            if (have_baseline && counters.have_prev &&
+                rx_bytes >= counters.prev_rx && tx_bytes >= counters.prev_tx) {
+                counters.rx_bps =
+                    static_cast<double>(rx_bytes - counters.prev_rx) / elapsed_sec;
+                counters.tx_bps =
+                    static_cast<double>(tx_bytes - counters.prev_tx) / elapsed_sec;
+            } else {
+                counters.rx_bps = counters.tx_bps = 0.0;
+            }
+            counters.prev_rx = rx_bytes;
+            counters.prev_tx = tx_bytes;
+            counters.have_prev = true;
+
+            if (interface_names[id] != "lo") {
+                total_rx_bps += counters.rx_bps;
+                total_tx_bps += counters.tx_bps;
             }
+            staged_interface_rates.push_back(
+                {interface_names[id], counters.rx_bps, counters.tx_bps});
+
+            p = strchr(p, '\n');
+            if (p) ++p;
         }
-        
-        return {rx_bytes, tx_bytes};
+
+        return {total_rx_bps, total_tx_bps};
     }
     
-    std::vector<ProcessInfo> get_top_processes(size_t count) {
-        std::vector<ProcessInfo> processes;
-        
-        DIR* proc_dir = opendir("/proc");
-        if (!proc_dir) return processes;
-        
-        struct dirent* entry;
-        while ((entry = readdir(proc_dir)) != nullptr && processes.size() < count) {
-            if (!isdigit(entry->d_name[0])) continue;
-            
-            ProcessInfo info;
-            info.pid = std::stoul(entry->d_name);
-            
-            // Read process info from /proc/[pid]/stat
-            std::string stat_file = "/proc/" + std::string(entry->d_name) + "/stat";
-            std::ifstream file(stat_file);
-            if (!file.is_open()) continue;
-            
-            std::string line;
-            std::getline(file, line);
-            
-            std::istringstream iss(line);
-            std::string pid_str, comm;
-            iss >> pid_str >> comm;
-            
-            info.name = comm.substr(1, comm.length() - 2); // Remove parentheses
-            info.cpu_percent = 0.0; // Would need more complex calculation
-            info.memory_bytes = 0; // Would need to read from /proc/[pid]/status
-            info.status = "running";
-            
-            processes.push_back(info);
+    // Scanner state, touched only by the process worker. CPU% needs the
+    // previous tick counts per pid; the buffer is reused across all
+    // /proc/[pid]/stat reads in a scan.
+    std::unordered_map<uint32_t, unsigned long long> prev_proc_ticks;
+    std::unordered_map<uint32_t, unsigned long long> curr_proc_ticks;
+    std::chrono::steady_clock::time_point last_proc_scan{};
+    char proc_stat_buffer[4096];
+
+    // Incremental process tracking via the netlink proc connector:
+    // fork/exec/exit events keep tracked_pids current, so a scan reads
+    // /proc/[pid]/stat only for known-live pids — work proportional to
+    // process churn instead of total process count. The subscription
+    // needs CAP_NET_ADMIN; when it can't be made every scan falls back
+    // to the full /proc rescan. A full reconcile still runs every
+    // RECONCILE_EVERY scans as a safety net against dropped messages.
+    static const int RECONCILE_EVERY = 30;
+    int proc_events_fd = -1;
+    bool proc_events_attempted = false;
+    bool proc_events_active = false;
+    bool proc_events_lost = false; // ENOBUFS: force an early reconcile
+    int scans_since_reconcile = RECONCILE_EVERY; // first scan reconciles
+    std::unordered_set<uint32_t> tracked_pids;
+
+    bool init_process_events() {
+        int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                        NETLINK_CONNECTOR);
+        if (fd < 0) return false;
+
+        sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = CN_IDX_PROC;
+        addr.nl_pid = static_cast<uint32_t>(getpid());
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            return false;
         }
-        
-        closedir(proc_dir);
-        return processes;
-    }
-#endif
-};
 
-class WebServer {
-private:
-    SystemMetrics* metrics;
-    std::atomic<bool> running{false};
-    std::thread server_thread;
-    Logger logger;
-    
-public:
-    WebServer(SystemMetrics* m) : metrics(m), logger("WebServer") {}
-    
-    void start(int port = 9000) {
-        if (running.load()) return;
-        
-        running.store(true);
-        server_thread = std::thread(&WebServer::run_server, this, port);
-        logger.info("Web server started on port " + std::to_string(port));
+        char buffer[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+        nlmsghdr* nl = reinterpret_cast<nlmsghdr*>(buffer);
+        nl->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+        nl->nlmsg_type = NLMSG_DONE;
+        nl->nlmsg_pid = static_cast<uint32_t>(getpid());
+
+        cn_msg* cn = reinterpret_cast<cn_msg*>(NLMSG_DATA(nl));
+        cn->id.idx = CN_IDX_PROC;
+        cn->id.val = CN_VAL_PROC;
+        cn->len = sizeof(proc_cn_mcast_op);
+        *reinterpret_cast<proc_cn_mcast_op*>(cn->data) = PROC_CN_MCAST_LISTEN;
+
+        if (send(fd, buffer, nl->nlmsg_len, 0) < 0) {
+            close(fd);
+            return false;
+        }
+
+        proc_events_fd = fd;
+        return true;
     }
-    
-    void stop() {
-        running.store(false);
-        if (server_thread.joinable()) {
-            server_thread.join();
+
+    // Applies all queued fork/exec/exit events to tracked_pids. Thread
+    // events are filtered out: only thread-group leaders matter here.
+    void drain_process_events() {
+        char buffer[4096];
+        while (true) {
+            ssize_t n = recv(proc_events_fd, buffer, sizeof(buffer), 0);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == ENOBUFS) {
+                    proc_events_lost = true; // kernel dropped events
+                    continue;
+                }
+                break; // EAGAIN: queue drained
+            }
+            if (n == 0) break;
+
+            size_t remaining = static_cast<size_t>(n);
+            for (nlmsghdr* nl = reinterpret_cast<nlmsghdr*>(buffer);
+                 NLMSG_OK(nl, remaining); nl = NLMSG_NEXT(nl, remaining)) {
+                cn_msg* cn = reinterpret_cast<cn_msg*>(NLMSG_DATA(nl));
+                if (cn->id.idx != CN_IDX_PROC) continue;
+
+                const proc_event* event =
+                    reinterpret_cast<const proc_event*>(cn->data);
+                switch (event->what) {
+                    case proc_event::PROC_EVENT_FORK:
+                        if (event->event_data.fork.child_pid ==
+                            event->event_data.fork.child_tgid) {
+                            tracked_pids.insert(static_cast<uint32_t>(
+                                event->event_data.fork.child_tgid));
+                        }
+                        break;
+                    case proc_event::PROC_EVENT_EXIT:
+                        if (event->event_data.exit.process_pid ==
+                            event->event_data.exit.process_tgid) {
+                            tracked_pids.erase(static_cast<uint32_t>(
+                                event->event_data.exit.process_tgid));
+                        }
+                        break;
+                    default:
+                        break; // exec/uid/comm don't change liveness
+                }
+            }
         }
-        logger.info("Web server stopped");
     }
-    
-private:
-    void run_server(int port) {
-        // Simplified HTTP server implementation
-        // In a real implementation, you'd use a proper HTTP library like cpp-httplib
-        while (running.load()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    static ProcessState process_state_from_char(char state) {
+        switch (state) {
+            case 'R': return ProcessState::Running;
+            case 'S': return ProcessState::Sleeping;
+            case 'D': return ProcessState::DiskSleep;
+            case 'Z': return ProcessState::Zombie;
+            case 'T': case 't': return ProcessState::Stopped;
+            case 'I': return ProcessState::Idle;
+            default:  return ProcessState::Unknown;
         }
     }
+
+    void scan_top_processes(ProcessTable& table, size_t count, bool enrich) {
+        if (!proc_events_attempted) {
+            proc_events_attempted = true;
+            proc_events_active = init_process_events();
+            logger.info(proc_events_active
+                            ? "Process events: netlink proc connector active"
+                            : "Process events unavailable; using full /proc rescans");
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed_sec =
+            std::chrono::duration<double>(now - last_proc_scan).count();
+        bool have_baseline = last_proc_scan.time_since_epoch().count() != 0 &&
+                             elapsed_sec > 0.0;
+        last_proc_scan = now;
+
+        static const long ticks_per_sec = sysconf(_SC_CLK_TCK);
+        static const long page_size = sysconf(_SC_PAGESIZE);
+
+        table.reserve(512, 8192);
+        curr_proc_ticks.clear();
+
+        // Parses one stat read and folds it into the table; returns
+        // false when the pid is gone or unreadable.
+        auto sample_stat_fd = [&](int fd) -> bool {
+            ssize_t n = pread(fd, proc_stat_buffer, sizeof(proc_stat_buffer) - 1, 0);
+            if (n <= 0) return false;
+            proc_stat_buffer[n] = '\0';
+
+            PidStatRecord record;
+            if (!parse_pid_stat(proc_stat_buffer, record)) return false;
+
+            uint32_t pid = record.pid;
+            unsigned long long total_ticks = record.utime + record.stime;
+            curr_proc_ticks[pid] = total_ticks;
+
+            double cpu_percent = 0.0;
+            if (have_baseline) {
+                auto prev = prev_proc_ticks.find(pid);
+                if (prev != prev_proc_ticks.end() && total_ticks >= prev->second) {
+                    double delta_sec = static_cast<double>(total_ticks - prev->second) /
+                                       static_cast<double>(ticks_per_sec);
+                    cpu_percent = delta_sec / elapsed_sec * 100.0;
+                }
+            }
+
+            table.add(pid, record.name_begin,
+                      static_cast<size_t>(record.name_end - record.name_begin),
+                      cpu_percent,
+                      record.rss_pages * static_cast<uint64_t>(page_size),
+                      process_state_from_char(record.state));
+            return true;
+        };
+
+        bool full_rescan = !proc_events_active;
+        if (proc_events_active) {
+            drain_process_events();
+            if (proc_events_lost || ++scans_since_reconcile >= RECONCILE_EVERY) {
+                full_rescan = true;
+            }
+        }
+
+        if (full_rescan) {
+            DIR* proc_dir = opendir("/proc");
+            if (!proc_dir) return;
+            int proc_fd = dirfd(proc_dir);
+
+            if (proc_events_active) {
+                tracked_pids.clear();
+            }
+
+            struct dirent* entry;
+            char path_buffer[NAME_MAX + 8];
+            while ((entry = readdir(proc_dir)) != nullptr) {
+                if (!isdigit(entry->d_name[0])) continue;
+
+                // One openat/pread/close per pid, no iostream in the loop.
+                snprintf(path_buffer, sizeof(path_buffer), "%s/stat", entry->d_name);
+                int fd = openat(proc_fd, path_buffer, O_RDONLY);
+                if (fd < 0) continue; // process exited mid-scan
+
+                bool sampled = sample_stat_fd(fd);
+                close(fd);
+                if (sampled && proc_events_active) {
+                    tracked_pids.insert(
+                        static_cast<uint32_t>(atol(entry->d_name)));
+                }
+            }
+
+            closedir(proc_dir);
+            scans_since_reconcile = 0;
+            proc_events_lost = false;
+        } else {
+            // Incremental pass: only the pids the tracker says are live.
+            std::vector<uint32_t> dead;
+            char path_buffer[64];
+            for (uint32_t pid : tracked_pids) {
+                snprintf(path_buffer, sizeof(path_buffer), "/proc/%u/stat", pid);
+                int fd = open(path_buffer, O_RDONLY | O_CLOEXEC);
+                bool sampled = fd >= 0 && sample_stat_fd(fd);
+                if (fd >= 0) close(fd);
+                if (!sampled) dead.push_back(pid); // missed exit event
+            }
+            for (uint32_t pid : dead) {
+                tracked_pids.erase(pid);
+            }
+        }
+
+        // Swap so dead pids drop out instead of accumulating forever.
+        prev_proc_ticks.swap(curr_proc_ticks);
+
+        auto& records = table.records();
+        size_t top = std::min(count, records.size());
+        std::partial_sort(records.begin(), records.begin() + top, records.end(),
+                          [](const ProcessRecord& a, const ProcessRecord& b) {
+                              if (a.cpu_percent != b.cpu_percent) {
+                                  return a.cpu_percent > b.cpu_percent;
+                              }
+                              return a.memory_bytes > b.memory_bytes;
+                          });
+        table.truncate(top);
+
+        // The expensive per-pid reads (smaps_rollup, io) run only for
+        // the N survivors of the cheap stat pre-filter, reusing the
+        // same buffer, so their cost is bounded by N regardless of how
+        // many processes the host runs. The governor drops them
+        // entirely while shedding.
+        if (enrich) {
+            for (ProcessRecord& record : table.records()) {
+                enrich_process_record(record);
+            }
+        }
+    }
+
+    // Looks up "Key:" in a /proc key-value buffer; 0 when absent.
+    static uint64_t parse_proc_kv_field(const char* buffer, const char* key) {
+        const char* p = strstr(buffer, key);
+        if (!p) return 0;
+        p += strlen(key);
+        while (*p == ' ' || *p == '\t') ++p;
+        return parse_ull_field(p);
+    }
+
+    // PSS from smaps_rollup and cumulative block-I/O bytes from io;
+    // both can be unreadable for other users' processes, which leaves
+    // the fields at zero.
+    void enrich_process_record(ProcessRecord& record) {
+        char path_buffer[64];
+
+        snprintf(path_buffer, sizeof(path_buffer), "/proc/%u/smaps_rollup",
+                 record.pid);
+        int fd = open(path_buffer, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            ssize_t n = pread(fd, proc_stat_buffer, sizeof(proc_stat_buffer) - 1, 0);
+            close(fd);
+            if (n > 0) {
+                proc_stat_buffer[n] = '\0';
+                record.pss_bytes =
+                    parse_proc_kv_field(proc_stat_buffer, "Pss:") * 1024;
+            }
+        }
+
+        snprintf(path_buffer, sizeof(path_buffer), "/proc/%u/io", record.pid);
+        fd = open(path_buffer, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            ssize_t n = pread(fd, proc_stat_buffer, sizeof(proc_stat_buffer) - 1, 0);
+            close(fd);
+            if (n > 0) {
+                proc_stat_buffer[n] = '\0';
+                // "write_bytes:" precedes "cancelled_write_bytes:", so
+                // a first-match scan picks the right field.
+                record.io_read_bytes =
+                    parse_proc_kv_field(proc_stat_buffer, "read_bytes:");
+                record.io_write_bytes =
+                    parse_proc_kv_field(proc_stat_buffer, "write_bytes:");
+            }
+        }
+    }
+#endif
+};
+
+// Federation tier: scrapes the /metrics endpoint of every configured
+// peer from one epoll loop over pooled keep-alive connections — one
+// thread regardless of fleet size, no per-peer threads. Each round the
+// previous round's samples are merged and rendered once; /fleet
+// readers share the published buffer. A peer that stops answering ages
+// out of the "up" set instead of blocking the round.
+class FleetScraper {
+private:
+    std::vector<PeerConfig> peer_configs;
+    std::atomic<bool> running{false};
+    std::thread scrape_thread;
+    Logger logger;
+
+    std::mutex result_mutex;
+    std::shared_ptr<const std::string> fleet_json;
+
+public:
+    explicit FleetScraper(std::vector<PeerConfig> peers)
+        : peer_configs(std::move(peers)), logger("FleetScraper") {}
+
+    // Most recent rendered fleet view; null before the first round.
+    std::shared_ptr<const std::string> latest_json() {
+        std::lock_guard<std::mutex> lock(result_mutex);
+        return fleet_json;
+    }
+
+    void start() {
+        if (running.load()) return;
+#ifdef _WIN32
+        logger.warn("Fleet mode requires the Linux build");
+#else
+        stop_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        running.store(true);
+        scrape_thread = std::thread(&FleetScraper::scrape_loop, this);
+        logger.info("Fleet scraper started for " +
+                    std::to_string(peer_configs.size()) + " peers");
+#endif
+    }
+
+    void stop() {
+        if (!running.load()) return;
+        running.store(false);
+#ifndef _WIN32
+        if (stop_event >= 0) {
+            uint64_t kick = 1;
+            ssize_t ignored = write(stop_event, &kick, sizeof(kick));
+            (void)ignored;
+        }
+#endif
+        if (scrape_thread.joinable()) {
+            scrape_thread.join();
+        }
+#ifndef _WIN32
+        if (stop_event >= 0) {
+            close(stop_event);
+            stop_event = -1;
+        }
+#endif
+    }
+
+private:
+#ifndef _WIN32
+    static const int64_t SCRAPE_INTERVAL_MS = 1000;
+    // Unanswered this long -> close and reconnect next round.
+    static const int64_t REQUEST_TIMEOUT_MS = 2000;
+    // Without a fresh sample this long the host reads as down.
+    static const int64_t SAMPLE_STALE_MS = 3 * SCRAPE_INTERVAL_MS;
+    // Failed name lookups are retried at this cadence, not every round:
+    // getaddrinfo blocks the scrape thread.
+    static const int64_t RESOLVE_RETRY_MS = 5000;
+
+    int stop_event = -1;
+
+    struct Peer {
+        PeerConfig config;
+        sockaddr_in addr{};
+        bool resolved = false;
+        int fd = -1;
+        enum class State { Disconnected, Connecting, AwaitingResponse, Idle };
+        State state = State::Disconnected;
+        std::string request;    // prebuilt keep-alive GET, reused per round
+        std::string in_buffer;
+        int64_t request_sent_ms = 0;
+        int64_t next_resolve_ms = 0;
+        PeerSample sample;
+    };
+
+    static int64_t wall_clock_ms() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    void scrape_loop() {
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd < 0) {
+            logger.error("fleet epoll_create1 failed: " + std::string(strerror(errno)));
+            return;
+        }
+        epoll_event stop_ev{};
+        stop_ev.events = EPOLLIN;
+        stop_ev.data.u64 = UINT64_MAX;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_event, &stop_ev);
+
+        std::vector<Peer> peers(peer_configs.size());
+        for (size_t i = 0; i < peers.size(); ++i) {
+            Peer& peer = peers[i];
+            peer.config = peer_configs[i];
+            peer.request = "GET /metrics HTTP/1.1\r\nHost: " + peer.config.label +
+                           "\r\nConnection: keep-alive\r\n\r\n";
+            resolve_peer(peer);
+            peer.next_resolve_ms = wall_clock_ms() + RESOLVE_RETRY_MS;
+        }
+
+        int64_t next_round = wall_clock_ms();
+        epoll_event events[64];
+        while (running.load()) {
+            int64_t now = wall_clock_ms();
+            if (now >= next_round) {
+                publish_round(peers, now);
+                begin_round(epoll_fd, peers, now);
+                next_round = now + SCRAPE_INTERVAL_MS;
+            }
+
+            int timeout = static_cast<int>(
+                std::max<int64_t>(1, next_round - wall_clock_ms()));
+            int ready = epoll_wait(epoll_fd, events, 64, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                logger.error("fleet epoll_wait failed: " + std::string(strerror(errno)));
+                break;
+            }
+
+            now = wall_clock_ms();
+            for (int i = 0; i < ready; ++i) {
+                if (events[i].data.u64 == UINT64_MAX) continue;
+                Peer& peer = peers[events[i].data.u64];
+                handle_peer_io(epoll_fd, peer, events[i].events,
+                               events[i].data.u64, now);
+            }
+        }
+
+        for (Peer& peer : peers) {
+            if (peer.fd >= 0) close(peer.fd);
+        }
+        close(epoll_fd);
+    }
+
+    void resolve_peer(Peer& peer) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(peer.config.host.c_str(),
+                        std::to_string(peer.config.port).c_str(),
+                        &hints, &result) != 0 || !result) {
+            logger.warn("Cannot resolve peer " + peer.config.label);
+            return;
+        }
+        std::memcpy(&peer.addr, result->ai_addr, sizeof(peer.addr));
+        peer.resolved = true;
+        freeaddrinfo(result);
+    }
+
+    // Renders the fleet view from the previous round's samples. Staleness
+    // is judged here so a silent peer decays to down without its socket
+    // ever reporting an error.
+    void publish_round(std::vector<Peer>& peers, int64_t now) {
+        std::vector<PeerSample> samples;
+        samples.reserve(peers.size());
+        for (Peer& peer : peers) {
+            if (peer.sample.up && now - peer.sample.sampled_ms > SAMPLE_STALE_MS) {
+                peer.sample.up = false;
+            }
+            samples.push_back(peer.sample);
+        }
+
+        auto body = std::make_shared<const std::string>(
+            format_fleet_json(peer_configs, samples));
+        std::lock_guard<std::mutex> lock(result_mutex);
+        fleet_json = std::move(body);
+    }
+
+    void begin_round(int epoll_fd, std::vector<Peer>& peers, int64_t now) {
+        for (size_t i = 0; i < peers.size(); ++i) {
+            Peer& peer = peers[i];
+            // A peer that failed to resolve at startup isn't dropped for
+            // good (DNS may simply not be up yet); keep retrying it at a
+            // gentler cadence than the scrape rounds.
+            if (!peer.resolved) {
+                if (now >= peer.next_resolve_ms) {
+                    peer.next_resolve_ms = now + RESOLVE_RETRY_MS;
+                    resolve_peer(peer);
+                }
+                if (!peer.resolved) continue;
+            }
+
+            // A request outstanding past the timeout means the
+            // connection is wedged; rebuild it next round.
+            if ((peer.state == Peer::State::Connecting ||
+                 peer.state == Peer::State::AwaitingResponse) &&
+                now - peer.request_sent_ms > REQUEST_TIMEOUT_MS) {
+                reset_peer(epoll_fd, peer);
+            }
+
+            if (peer.state == Peer::State::Disconnected) {
+                connect_peer(epoll_fd, peer, i, now);
+            } else if (peer.state == Peer::State::Idle) {
+                send_request(peer, now);
+            }
+        }
+    }
+
+    void connect_peer(int epoll_fd, Peer& peer, size_t index, int64_t now) {
+        peer.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (peer.fd < 0) return;
+
+        int rc = connect(peer.fd, reinterpret_cast<sockaddr*>(&peer.addr),
+                         sizeof(peer.addr));
+        if (rc < 0 && errno != EINPROGRESS) {
+            close(peer.fd);
+            peer.fd = -1;
+            return;
+        }
+
+        peer.state = Peer::State::Connecting;
+        peer.request_sent_ms = now;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT;
+        ev.data.u64 = index;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, peer.fd, &ev);
+    }
+
+    // The request is a few dozen bytes; a fresh or idle keep-alive
+    // socket always has that much buffer, so a short write means the
+    // connection is broken anyway.
+    void send_request(Peer& peer, int64_t now) {
+        ssize_t n = write(peer.fd, peer.request.data(), peer.request.size());
+        if (n == static_cast<ssize_t>(peer.request.size())) {
+            peer.state = Peer::State::AwaitingResponse;
+            peer.request_sent_ms = now;
+        } else {
+            peer.state = Peer::State::Disconnected; // reset on next round
+        }
+    }
+
+    void handle_peer_io(int epoll_fd, Peer& peer, uint32_t events,
+                        uint64_t index, int64_t now) {
+        if (peer.fd < 0) return;
+
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            reset_peer(epoll_fd, peer);
+            return;
+        }
+
+        if (peer.state == Peer::State::Connecting && (events & EPOLLOUT)) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(peer.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err != 0) {
+                reset_peer(epoll_fd, peer);
+                return;
+            }
+            send_request(peer, now);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = index;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, peer.fd, &ev);
+        }
+
+        if (events & EPOLLIN) {
+            char buffer[8192];
+            while (true) {
+                ssize_t n = read(peer.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    peer.in_buffer.append(buffer, static_cast<size_t>(n));
+                } else if (n == 0) {
+                    reset_peer(epoll_fd, peer);
+                    return;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                } else if (errno == EINTR) {
+                    continue;
+                } else {
+                    reset_peer(epoll_fd, peer);
+                    return;
+                }
+            }
+            consume_response(epoll_fd, peer, now);
+        }
+    }
+
+    // Completes when Content-Length bytes of body have arrived; the
+    // connection then idles for the next round's request.
+    void consume_response(int epoll_fd, Peer& peer, int64_t now) {
+        size_t header_end = peer.in_buffer.find("\r\n\r\n");
+        if (header_end == std::string::npos) return;
+
+        size_t length_pos = peer.in_buffer.find("Content-Length: ");
+        if (length_pos == std::string::npos || length_pos > header_end) {
+            reset_peer(epoll_fd, peer); // can't frame the body
+            return;
+        }
+        size_t body_length = static_cast<size_t>(
+            std::atol(peer.in_buffer.c_str() + length_pos + 16));
+        size_t body_start = header_end + 4;
+        if (peer.in_buffer.size() < body_start + body_length) return;
+
+        PeerSample sample;
+        if (parse_peer_metrics(
+                peer.in_buffer.substr(body_start, body_length), sample)) {
+            sample.up = true;
+            sample.sampled_ms = now;
+            peer.sample = sample;
+        }
+        peer.in_buffer.erase(0, body_start + body_length);
+        peer.state = Peer::State::Idle;
+    }
+
+    void reset_peer(int epoll_fd, Peer& peer) {
+        if (peer.fd >= 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, peer.fd, nullptr);
+            close(peer.fd);
+            peer.fd = -1;
+        }
+        peer.state = Peer::State::Disconnected;
+        peer.in_buffer.clear();
+    }
+#else
+    void scrape_loop() {}
+#endif
+};
+
+class WebServer {
+private:
+    SystemMetrics* metrics;
+    FleetScraper* fleet = nullptr;  // set when running as a federation tier
+    std::atomic<bool> running{false};
+    std::thread server_thread;
+    Logger logger;
+
+    // A response body plus the ETag it was rendered under. Bodies are
+    // shared_ptr so a cached render can be handed to many connections
+    // without duplicating the serialization work.
+    struct HttpResponse {
+        std::shared_ptr<const std::string> body;
+        std::string etag;
+        const char* content_type = "application/json";
+        int status = 200;
+    };
+
+    // One pre-rendered body, invalidated when the monitor loop's data
+    // generation moves on. Rendering is lazy: the first reader after a
+    // tick pays for serialization, everyone else reuses the buffer.
+    struct ResponseCache {
+        std::mutex mutex;
+        uint64_t generation = ~0ull;
+        std::shared_ptr<const std::string> body;
+    };
+
+    ResponseCache metrics_cache;
+    ResponseCache history_cache;
+    ResponseCache prometheus_cache;
+
+public:
+    WebServer(SystemMetrics* m) : metrics(m), logger("WebServer") {}
+
+    void attach_fleet(FleetScraper* scraper) { fleet = scraper; }
+
+    void start(int port = 9000) {
+        if (running.load()) return;
+        
+        running.store(true);
+        server_thread = std::thread(&WebServer::run_server, this, port);
+        logger.info("Web server started on port " + std::to_string(port));
+    }
     
-    std::string handle_request(const std::string& path) {
+    void stop() {
+        running.store(false);
+#ifndef _WIN32
+        // Wake the acceptor and every worker immediately instead of
+        // waiting out their epoll timeouts.
+        if (shutdown_event >= 0) {
+            uint64_t kick = 1;
+            ssize_t ignored = write(shutdown_event, &kick, sizeof(kick));
+            (void)ignored;
+        }
+#endif
+        if (server_thread.joinable()) {
+            server_thread.join();
+        }
+#ifndef _WIN32
+        if (shutdown_event >= 0) {
+            close(shutdown_event);
+            shutdown_event = -1;
+        }
+#endif
+        logger.info("Web server stopped");
+    }
+    
+private:
+#ifdef _WIN32
+    void run_server(int port) {
+        // IOCP port not implemented yet; Windows builds keep the idle stub.
+        (void)port;
+        while (running.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+#else
+    // One queued write: bytes the connection owns (headers, SSE
+    // preamble) or a reference into a shared cached body. Bodies ride
+    // as shared_ptr references, so a connection holding a day-range
+    // /history response costs a header string plus a pointer, not a
+    // copy of the payload — fifty simultaneous scrapers share the one
+    // rendered buffer.
+    struct OutSegment {
+        std::string owned;
+        std::shared_ptr<const std::string> shared;
+
+        const char* data() const { return shared ? shared->data() : owned.data(); }
+        size_t size() const { return shared ? shared->size() : owned.size(); }
+    };
+
+    // Per-connection state for the epoll loop.
+    struct Connection {
+        std::string in_buffer;
+        std::deque<OutSegment> out_queue;
+        size_t out_offset = 0; // consumed bytes of the front segment
+        bool close_after_write = false;
+        bool is_stream = false; // subscribed to /stream (SSE), never expires
+    };
+
+    static void queue_owned(Connection& conn, std::string bytes) {
+        if (bytes.empty()) return;
+        OutSegment segment;
+        segment.owned = std::move(bytes);
+        conn.out_queue.push_back(std::move(segment));
+    }
+
+    static void queue_shared(Connection& conn,
+                             std::shared_ptr<const std::string> bytes) {
+        if (!bytes || bytes->empty()) return;
+        OutSegment segment;
+        segment.shared = std::move(bytes);
+        conn.out_queue.push_back(std::move(segment));
+    }
+
+    // Lock-free single-producer/single-consumer ring carrying accepted
+    // fds from the acceptor thread to one worker. Fixed capacity; a
+    // full ring means the worker is badly behind and the caller sheds
+    // the connection instead of queueing unbounded work.
+    class SpscFdRing {
+    public:
+        bool push(int fd) {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) == CAPACITY) {
+                return false;
+            }
+            slots_[head % CAPACITY] = fd;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(int& fd) {
+            uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            fd = slots_[tail % CAPACITY];
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        static const size_t CAPACITY = 256;
+        int slots_[CAPACITY];
+        std::atomic<uint64_t> head_{0};
+        std::atomic<uint64_t> tail_{0};
+    };
+
+    // One request-pipeline worker. Each worker owns its epoll set and
+    // its connections outright: no accept mutex, no shared epoll, no
+    // thundering herd. The acceptor hands over fresh fds through the
+    // inbox ring and kicks the eventfd to wake the worker's epoll.
+    struct Worker {
+        SpscFdRing inbox;
+        int wake_fd = -1;
+        std::thread thread;
+    };
+
+    // Enough to keep /history rendering from head-of-line-blocking
+    // /health probes; more workers than this just shuffles cache lines
+    // for our request mix.
+    static const size_t WORKER_COUNT = 4;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Written by stop(), watched by the acceptor and all workers; never
+    // drained, so one kick wakes every loop.
+    int shutdown_event = -1;
+
+    // Acceptor: owns the listen socket and round-robins accepted fds
+    // across the workers. Runs on server_thread.
+    void run_server(int port) {
+        int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) {
+            logger.error("socket() failed: " + std::string(strerror(errno)));
+            return;
+        }
+
+        int one = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(listen_fd, 512) < 0) {
+            logger.error("bind/listen failed on port " + std::to_string(port) +
+                         ": " + std::string(strerror(errno)));
+            close(listen_fd);
+            return;
+        }
+
+        int accept_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (accept_epoll < 0) {
+            logger.error("epoll_create1 failed: " + std::string(strerror(errno)));
+            close(listen_fd);
+            return;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listen_fd;
+        epoll_ctl(accept_epoll, EPOLL_CTL_ADD, listen_fd, &ev);
+
+        shutdown_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        ev.events = EPOLLIN;
+        ev.data.fd = shutdown_event;
+        epoll_ctl(accept_epoll, EPOLL_CTL_ADD, shutdown_event, &ev);
+
+        for (size_t i = 0; i < WORKER_COUNT; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            worker->thread = std::thread(&WebServer::worker_loop, this, worker.get());
+            workers.push_back(std::move(worker));
+        }
+
+        size_t next_worker = 0;
+        epoll_event events[4];
+
+        // Short timeout so the running flag is honored promptly on stop().
+        while (running.load()) {
+            int ready = epoll_wait(accept_epoll, events, 4, 200);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                logger.error("epoll_wait failed: " + std::string(strerror(errno)));
+                break;
+            }
+            if (ready == 0) continue;
+            if (!running.load()) break; // shutdown_event fired
+
+            while (true) {
+                int fd = accept4(listen_fd, nullptr, nullptr,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                        logger.error("accept failed: " + std::string(strerror(errno)));
+                    }
+                    break;
+                }
+
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                Worker& worker = *workers[next_worker];
+                next_worker = (next_worker + 1) % workers.size();
+
+                if (!worker.inbox.push(fd)) {
+                    close(fd); // worker hopelessly behind; shed load
+                    continue;
+                }
+                uint64_t kick = 1;
+                ssize_t ignored = write(worker.wake_fd, &kick, sizeof(kick));
+                (void)ignored;
+            }
+        }
+
+        running.store(false);
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+            close(worker->wake_fd);
+        }
+        workers.clear();
+
+        close(accept_epoll);
+        close(listen_fd);
+    }
+
+    // Per-worker event loop: one epoll set, one connection table, no
+    // state shared with the other workers beyond the response caches.
+    void worker_loop(Worker* worker) {
+        int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            logger.error("worker epoll_create1 failed: " + std::string(strerror(errno)));
+            return;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = worker->wake_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, worker->wake_fd, &ev);
+
+        ev.events = EPOLLIN;
+        ev.data.fd = shutdown_event;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, shutdown_event, &ev);
+
+        std::unordered_map<int, Connection> connections;
+        uint64_t last_stream_generation = ~0ull;
+        epoll_event events[64];
+
+        while (running.load()) {
+            int ready = epoll_wait(epoll_fd, events, 64, 200);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                logger.error("worker epoll_wait failed: " + std::string(strerror(errno)));
+                break;
+            }
+
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+
+                if (fd == shutdown_event) continue; // loop condition exits
+
+                if (fd == worker->wake_fd) {
+                    uint64_t drained;
+                    while (read(worker->wake_fd, &drained, sizeof(drained)) > 0) {
+                    }
+                    adopt_new_connections(epoll_fd, *worker, connections);
+                    continue;
+                }
+
+                auto it = connections.find(fd);
+                if (it == connections.end()) continue;
+
+                bool alive = true;
+                if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    alive = false;
+                } else {
+                    if (events[i].events & EPOLLIN) {
+                        alive = read_from_connection(fd, it->second);
+                    }
+                    if (alive && !it->second.out_queue.empty()) {
+                        alive = flush_connection(epoll_fd, fd, it->second);
+                    }
+                }
+
+                if (!alive) {
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                    close(fd);
+                    connections.erase(it);
+                }
+            }
+
+            push_stream_updates(epoll_fd, connections, last_stream_generation);
+        }
+
+        // Drain any fds handed over after the last wakeup so they close.
+        adopt_new_connections(epoll_fd, *worker, connections);
+        for (auto& conn : connections) {
+            close(conn.first);
+        }
+        close(epoll_fd);
+    }
+
+    void adopt_new_connections(int epoll_fd, Worker& worker,
+                               std::unordered_map<int, Connection>& connections) {
+        int fd;
+        while (worker.inbox.pop(fd)) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+            connections[fd];
+        }
+    }
+
+    // Reads available bytes and answers every complete request in the
+    // buffer (pipelined requests included). Returns false when the
+    // connection should be torn down.
+    bool read_from_connection(int fd, Connection& conn) {
+        char buffer[8192];
+        while (true) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                conn.in_buffer.append(buffer, static_cast<size_t>(n));
+                if (conn.in_buffer.size() > MAX_REQUEST_SIZE) {
+                    return false; // oversized request; drop the client
+                }
+            } else if (n == 0) {
+                return false; // peer closed
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else if (errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+
+        size_t header_end;
+        while ((header_end = conn.in_buffer.find("\r\n\r\n")) != std::string::npos) {
+            std::string request = conn.in_buffer.substr(0, header_end);
+            conn.in_buffer.erase(0, header_end + 4);
+
+            std::string method, target;
+            bool keep_alive, accept_binary;
+            if (!parse_request(request, method, target, keep_alive, accept_binary)) {
+                return false;
+            }
+
+            // /stream upgrades the connection to a server-push SSE
+            // subscription: send the headers, then leave it open for
+            // push_stream_updates to feed each tick.
+            if (target.compare(0, 7, "/stream") == 0) {
+                conn.is_stream = true;
+                queue_owned(conn,
+                    "HTTP/1.1 200 OK\r\n"
+                    "Content-Type: text/event-stream\r\n"
+                    "Cache-Control: no-cache\r\n"
+                    "Connection: keep-alive\r\n"
+                    "\r\n");
+                break;
+            }
+
+            HttpResponse response = handle_request(target, accept_binary);
+            queue_owned(conn, build_response_header(response, keep_alive));
+            queue_shared(conn, response.body);
+            if (!keep_alive) {
+                conn.close_after_write = true;
+                break;
+            }
+        }
+
+        return true;
+    }
+
+    // Fans the latest snapshot out to every /stream subscriber on this
+    // worker. The SSE frame is rendered once per monitor tick (reusing
+    // the cached /metrics body) and the same bytes go to every
+    // subscriber, so 30 dashboards cost one serialization plus 30
+    // socket writes.
+    void push_stream_updates(int epoll_fd,
+                             std::unordered_map<int, Connection>& connections,
+                             uint64_t& last_stream_generation) {
+        uint64_t generation = metrics->generation();
+        if (generation == last_stream_generation || generation == 0) {
+            return;
+        }
+        last_stream_generation = generation;
+
+        std::shared_ptr<const std::string> frame;
+        std::vector<int> dead;
+        for (auto& item : connections) {
+            Connection& conn = item.second;
+            if (!conn.is_stream) continue;
+
+            if (!frame) {
+                frame = std::make_shared<const std::string>(
+                    build_sse_frame(*serve_cached(metrics_cache, [this]() {
+                        return format_metrics_json(metrics->get_latest_metrics());
+                    }).body));
+            }
+
+            queue_shared(conn, frame);
+            if (!flush_connection(epoll_fd, item.first, conn)) {
+                dead.push_back(item.first);
+            }
+        }
+
+        for (int fd : dead) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            connections.erase(fd);
+        }
+    }
+
+    // SSE requires each payload line to carry its own "data:" prefix.
+    static std::string build_sse_frame(const std::string& body) {
+        std::string frame;
+        frame.reserve(body.size() + 64);
+        size_t start = 0;
+        while (start <= body.size()) {
+            size_t end = body.find('\n', start);
+            if (end == std::string::npos) end = body.size();
+            frame += "data: ";
+            frame.append(body, start, end - start);
+            frame += '\n';
+            start = end + 1;
+        }
+        frame += '\n';
+        return frame;
+    }
+
+    // Scatter-gather flush: gathers the queued segments into one writev
+    // so header and body leave in a single syscall without ever being
+    // concatenated into an intermediate heap string. Arms EPOLLOUT if
+    // the kernel buffer filled up. Returns false to tear down.
+    bool flush_connection(int epoll_fd, int fd, Connection& conn) {
+        while (!conn.out_queue.empty()) {
+            struct iovec iov[MAX_WRITE_IOVECS];
+            int iov_count = 0;
+            size_t skip = conn.out_offset;
+            for (const OutSegment& segment : conn.out_queue) {
+                if (iov_count == MAX_WRITE_IOVECS) break;
+                iov[iov_count].iov_base =
+                    const_cast<char*>(segment.data() + skip);
+                iov[iov_count].iov_len = segment.size() - skip;
+                ++iov_count;
+                skip = 0;
+            }
+
+            ssize_t n = writev(fd, iov, iov_count);
+            if (n > 0) {
+                size_t written = static_cast<size_t>(n);
+                while (written > 0) {
+                    size_t remaining =
+                        conn.out_queue.front().size() - conn.out_offset;
+                    if (written < remaining) {
+                        conn.out_offset += written;
+                        break;
+                    }
+                    written -= remaining;
+                    conn.out_queue.pop_front();
+                    conn.out_offset = 0;
+                }
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                epoll_event ev{};
+                ev.events = EPOLLIN | EPOLLOUT;
+                ev.data.fd = fd;
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+                return true;
+            } else if (errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+
+        if (conn.close_after_write) {
+            return false;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+        return true;
+    }
+
+    static bool parse_request(const std::string& request, std::string& method,
+                              std::string& target, bool& keep_alive,
+                              bool& accept_binary) {
+        size_t line_end = request.find("\r\n");
+        std::string request_line = request.substr(0, line_end);
+
+        size_t first_space = request_line.find(' ');
+        size_t second_space = request_line.find(' ', first_space + 1);
+        if (first_space == std::string::npos || second_space == std::string::npos) {
+            return false;
+        }
+
+        method = request_line.substr(0, first_space);
+        target = request_line.substr(first_space + 1, second_space - first_space - 1);
+        std::string version = request_line.substr(second_space + 1);
+
+        // HTTP/1.1 defaults to keep-alive; honor an explicit close.
+        keep_alive = (version == "HTTP/1.1");
+        std::string lowered = request;
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        if (lowered.find("connection: close") != std::string::npos) {
+            keep_alive = false;
+        } else if (lowered.find("connection: keep-alive") != std::string::npos) {
+            keep_alive = true;
+        }
+        accept_binary =
+            lowered.find("application/x-pm-columns") != std::string::npos;
+
+        return true;
+    }
+
+    static const char* status_text(int status) {
+        switch (status) {
+            case 200: return "200 OK";
+            case 400: return "400 Bad Request";
+            case 404: return "404 Not Found";
+            case 503: return "503 Service Unavailable";
+            default:  return "500 Internal Server Error";
+        }
+    }
+
+    // Header only; the body follows as its own segment in the iovec
+    // chain rather than being appended here.
+    static std::string build_response_header(const HttpResponse& http_response,
+                                             bool keep_alive) {
+        std::string response;
+        response.reserve(160);
+        response += "HTTP/1.1 ";
+        response += status_text(http_response.status);
+        response += "\r\n";
+        response += "Content-Type: ";
+        response += http_response.content_type;
+        response += "\r\n";
+        response += "Content-Length: " + std::to_string(http_response.body->size()) + "\r\n";
+        if (!http_response.etag.empty()) {
+            response += "ETag: " + http_response.etag + "\r\n";
+        }
+        response += keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+        response += "\r\n";
+        return response;
+    }
+
+    static const size_t MAX_REQUEST_SIZE = 16 * 1024;
+    static const int MAX_WRITE_IOVECS = 16;
+#endif
+
+    HttpResponse handle_request(const std::string& target, bool accept_binary = false) {
+        ScopedTimer probe(ProbeId::HandleRequest);
+        size_t query_pos = target.find('?');
+        std::string path = (query_pos == std::string::npos)
+                               ? target
+                               : target.substr(0, query_pos);
+        std::string query = (query_pos == std::string::npos)
+                                ? std::string()
+                                : target.substr(query_pos + 1);
+
         if (path == "/health") {
-            return R"({"status": "healthy", "service": "performance-monitor"})";
+            return plain_response(R"({"status": "healthy", "service": "performance-monitor"})");
         } else if (path == "/metrics") {
-            return format_metrics(metrics->get_current_metrics());
+            return serve_cached(metrics_cache, [this]() {
+                return format_metrics_json(metrics->get_latest_metrics());
+            });
+        } else if (path == "/metrics/prometheus") {
+            HttpResponse response = serve_cached(prometheus_cache, [this]() {
+                return format_prometheus_text(metrics->get_latest_metrics());
+            });
+            response.content_type = "text/plain; version=0.0.4";
+            return response;
         } else if (path == "/history") {
-            return format_history(metrics->get_history(100));
+            return handle_history(query, accept_binary);
         } else if (path == "/system") {
-            return metrics->get_system_info();
+            return plain_response(metrics->get_system_info());
+        } else if (path.rfind("/series/", 0) == 0) {
+            return format_series(path.substr(8));
+        } else if (path == "/debug/self") {
+            return plain_response(SelfStats::instance().render());
+        } else if (path == "/fleet") {
+            if (!fleet) {
+                return error_response(404, R"({"error": "Fleet mode not enabled"})");
+            }
+            HttpResponse response;
+            response.body = fleet->latest_json();
+            if (!response.body) {
+                return error_response(503, R"({"error": "No fleet data yet"})");
+            }
+            return response;
         }
-        
-        return R"({"error": "Not found"})";
+
+        return error_response(404, R"({"error": "Not found"})");
     }
-    
-    std::string format_metrics(const SystemMetrics::MetricSnapshot& snapshot) {
-        std::ostringstream json;
-        json << std::fixed << std::setprecision(2);
-        
-        json << "{\n";
-        json << "  \"timestamp\": " << std::chrono::duration_cast<std::chrono::milliseconds>(
-                snapshot.timestamp.time_since_epoch()).count() << ",\n";
-        json << "  \"cpu_usage\": " << snapshot.cpu_usage << ",\n";
-        json << "  \"memory_usage\": " << snapshot.memory_usage << ",\n";
-        json << "  \"disk_usage\": " << snapshot.disk_usage << ",\n";
-        json << "  \"network_rx\": " << snapshot.network_rx << ",\n";
-        json << "  \"network_tx\": " << snapshot.network_tx << ",\n";
-        json << "  \"top_processes\": [\n";
-        
-        for (size_t i = 0; i < snapshot.top_processes.size(); ++i) {
-            const auto& proc = snapshot.top_processes[i];
-            json << "    {\n";
-            json << "      \"pid\": " << proc.pid << ",\n";
-            json << "      \"name\": \"" << proc.name << "\",\n";
-            json << "      \"cpu_percent\": " << proc.cpu_percent << ",\n";
-            json << "      \"memory_bytes\": " << proc.memory_bytes << ",\n";
-            json << "      \"status\": \"" << proc.status << "\"\n";
-            json << "    }";
-            if (i < snapshot.top_processes.size() - 1) json << ",";
-            json << "\n";
+
+    // /history?res=raw|minute|hour&count=N. The bare raw query is the
+    // hot path (dashboards poll it) and stays cached per tick; rollup
+    // queries touch at most a couple thousand pre-computed records.
+    HttpResponse handle_history(const std::string& query, bool accept_binary) {
+        std::string resolution = get_query_param(query, "res");
+        std::string count_param = get_query_param(query, "count");
+
+        size_t requested = 0;
+        if (!parse_count_param(count_param, requested)) {
+            return error_response(400, R"({"error": "Invalid count"})");
         }
-        
-        json << "  ]\n";
-        json << "}";
-        
-        return json.str();
+
+        if (resolution.empty() || resolution == "raw") {
+            size_t count = count_param.empty() ? 100 : requested;
+            // Binary negotiation applies to raw history only; the
+            // rollup endpoints stay JSON.
+            if (accept_binary) {
+                HttpResponse response =
+                    plain_response(encode_history_columns(metrics->get_history(count)));
+                response.content_type = "application/x-pm-columns";
+                return response;
+            }
+            if (count_param.empty()) {
+                return serve_cached(history_cache, [this]() {
+                    return format_history_json(metrics->get_history(100));
+                });
+            }
+            return plain_response(format_history_json(metrics->get_history(count)));
+        }
+
+        HistoryResolution res;
+        if (resolution == "minute") {
+            res = HistoryResolution::Minute;
+        } else if (resolution == "hour") {
+            res = HistoryResolution::Hour;
+        } else {
+            return error_response(400, R"({"error": "Unknown resolution"})");
+        }
+
+        return plain_response(
+            format_rollup_history_json(resolution, metrics->get_rollup_history(res, requested)));
     }
-    
-    std::string format_history(const std::vector<SystemMetrics::MetricSnapshot>& history) {
+
+    // Parses a decimal count query parameter. Empty is allowed (the
+    // caller picks its default); anything non-numeric or absurdly long
+    // is rejected rather than letting std::stoul throw past us.
+    static bool parse_count_param(const std::string& value, size_t& out) {
+        out = 0;
+        if (value.empty()) return true;
+        if (value.size() > 9) return false;
+        for (char c : value) {
+            if (c < '0' || c > '9') return false;
+            out = out * 10 + static_cast<size_t>(c - '0');
+        }
+        return true;
+    }
+
+    static std::string get_query_param(const std::string& query, const std::string& key) {
+        size_t pos = 0;
+        while (pos < query.size()) {
+            size_t end = query.find('&', pos);
+            if (end == std::string::npos) end = query.size();
+            size_t eq = query.find('=', pos);
+            if (eq != std::string::npos && eq < end &&
+                query.compare(pos, eq - pos, key) == 0) {
+                return query.substr(eq + 1, end - eq - 1);
+            }
+            pos = end + 1;
+        }
+        return "";
+    }
+
+    static HttpResponse plain_response(std::string body) {
+        return {std::make_shared<const std::string>(std::move(body)), ""};
+    }
+
+    static HttpResponse error_response(int status, std::string body) {
+        HttpResponse response = plain_response(std::move(body));
+        response.status = status;
+        return response;
+    }
+
+    // Returns the cached body for the current data generation, rendering
+    // it at most once per monitor tick regardless of how many scrapers
+    // are polling. The generation doubles as a weak ETag.
+    template <typename RenderFn>
+    HttpResponse serve_cached(ResponseCache& cache, RenderFn render) {
+        uint64_t generation = metrics->generation();
+
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (cache.generation != generation || !cache.body) {
+            cache.body = std::make_shared<const std::string>(render());
+            cache.generation = generation;
+        }
+        return {cache.body, "W/\"" + std::to_string(generation) + "\""};
+    }
+
+    HttpResponse format_series(const std::string& name) {
+        MetricId id;
+        if (!metric_from_name(name, id)) {
+            return error_response(404, R"({"error": "Unknown series"})");
+        }
+
+        std::vector<int64_t> timestamps = metrics->get_series_timestamps();
+        std::vector<double> values = metrics->get_series(id);
+
         std::ostringstream json;
         json << std::fixed << std::setprecision(2);
-        
+
         json << "{\n";
-        json << "  \"data\": [\n";
-        
-        for (size_t i = 0; i < history.size(); ++i) {
-            const auto& snapshot = history[i];
-            json << "    {\n";
-            json << "      \"timestamp\": " << std::chrono::duration_cast<std::chrono::milliseconds>(
-                    snapshot.timestamp.time_since_epoch()).count() << ",\n";
-            json << "      \"cpu_usage\": " << snapshot.cpu_usage << ",\n";
-            json << "      \"memory_usage\": " << snapshot.memory_usage << ",\n";
-            json << "      \"disk_usage\": " << snapshot.disk_usage << "\n";
-            json << "    }";
-            if (i < history.size() - 1) json << ",";
-            json << "\n";
+        json << "  \"series\": \"" << name << "\",\n";
+        json << "  \"timestamps\": [";
+        for (size_t i = 0; i < timestamps.size(); ++i) {
+            if (i > 0) json << ", ";
+            json << timestamps[i];
         }
-        
-        json << "  ],\n";
-        json << "  \"count\": " << history.size() << "\n";
+        json << "],\n";
+        json << "  \"values\": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) json << ", ";
+            json << values[i];
+        }
+        json << "],\n";
+        json << "  \"count\": " << values.size() << "\n";
         json << "}";
-        
-        return json.str();
+
+        return plain_response(json.str());
     }
+    
+    
+
 };
 
 int main(int argc, char* argv[]) {
+#ifndef _WIN32
+    // Block SIGINT/SIGTERM before any thread exists — including the
+    // logger's flush thread — so every thread inherits the mask and the
+    // signals only ever surface through the signalfd below.
+    sigset_t shutdown_signals;
+    sigemptyset(&shutdown_signals);
+    sigaddset(&shutdown_signals, SIGINT);
+    sigaddset(&shutdown_signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &shutdown_signals, nullptr);
+    int signal_fd = signalfd(-1, &shutdown_signals, SFD_CLOEXEC);
+#endif
+
     try {
         Logger logger("Main");
         logger.info("Starting Performance Monitor...");
         
-        SystemMetrics metrics;
+        // Positional port plus optional per-collector sampling intervals,
+        // alert rules (--alert "cpu>80:30", repeatable), and fleet peers
+        // (--peer host[:port], repeatable).
+        SamplingConfig config;
+        std::vector<AlertRule> alert_rules = default_alert_rules();
+        std::vector<PeerConfig> peer_configs;
+        int port = DEFAULT_SERVER_PORT;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next_interval = [&](std::chrono::milliseconds& out) {
+                if (i + 1 < argc) out = std::chrono::milliseconds(std::stol(argv[++i]));
+            };
+            if (arg == "--alert") {
+                AlertRule rule;
+                if (i + 1 < argc && parse_alert_rule(argv[++i], rule)) {
+                    alert_rules.push_back(rule);
+                } else {
+                    logger.warn("Ignoring malformed alert rule: " +
+                                std::string(i < argc ? argv[i] : ""));
+                }
+            } else if (arg == "--peer") {
+                PeerConfig peer;
+                if (i + 1 < argc &&
+                    parse_peer_spec(argv[++i], DEFAULT_SERVER_PORT, peer)) {
+                    peer_configs.push_back(peer);
+                } else {
+                    logger.warn("Ignoring malformed peer spec: " +
+                                std::string(i < argc ? argv[i] : ""));
+                }
+            } else if (arg == "--cpu-interval-ms") {
+                next_interval(config.cpu_memory_interval);
+            } else if (arg == "--disk-interval-ms") {
+                next_interval(config.disk_interval);
+            } else if (arg == "--network-interval-ms") {
+                next_interval(config.network_interval);
+            } else if (arg == "--process-interval-ms") {
+                next_interval(config.process_interval);
+            } else if (arg == "--history-interval-ms") {
+                next_interval(config.history_interval);
+            } else if (arg == "--self-cpu-budget") {
+                if (i + 1 < argc) config.self_cpu_budget_percent = std::stod(argv[++i]);
+            } else {
+                port = std::stoi(arg);
+            }
+        }
+
+        SystemMetrics metrics(config, alert_rules);
         WebServer server(&metrics);
-        
+
+        std::unique_ptr<FleetScraper> fleet;
+        if (!peer_configs.empty()) {
+            fleet.reset(new FleetScraper(std::move(peer_configs)));
+            server.attach_fleet(fleet.get());
+        }
+
         // Start monitoring
         metrics.start_monitoring();
-        
+        if (fleet) fleet->start();
+
         // Start web server
-        int port = (argc > 1) ? std::stoi(argv[1]) : 9000;
         server.start(port);
-        
+
         logger.info("Performance Monitor running. Press Ctrl+C to stop.");
-        
-        // Keep running until interrupted
+
+#ifndef _WIN32
+        // Block until SIGINT/SIGTERM arrives; no polling loop.
+        signalfd_siginfo signal_info;
+        while (read(signal_fd, &signal_info, sizeof(signal_info)) < 0 &&
+               errno == EINTR) {
+        }
+        close(signal_fd);
+        logger.info("Shutdown signal received, draining...");
+#else
+        // No signalfd equivalent; park the main thread forever.
         while (true) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
-            
-            // Check for graceful shutdown signals
-            // In a real implementation, you'd handle SIGINT/SIGTERM
         }
-        
-        // Cleanup
+#endif
+
+        // Graceful drain: stop accepting, flush history, persist
+        // collector baselines.
         server.stop();
+        if (fleet) fleet->stop();
         metrics.stop_monitoring();
-        
+
         logger.info("Performance Monitor stopped.");
         
     } catch (const std::exception& e) {